@@ -0,0 +1,116 @@
+#ifndef MY_STL_ADDRESSABLE_PRIORITY_QUEUE_H
+#define MY_STL_ADDRESSABLE_PRIORITY_QUEUE_H
+//可寻址的优先队列：push返回一个句柄，之后可以凭句柄以O(log n)修改元素的优先级(decrease-key)或删除元素
+//元素按句柄存放，堆中只存句柄，另有一个数组记录每个句柄在堆中的位置，堆中移动句柄时随之更新
+//句柄在元素被pop或erase之前一直有效，之后可能被新元素重用
+//堆顶为comp意义下最大的元素，Dijkstra等需要小顶堆时Compare取greater
+#include <cstddef>
+#include "vector.h"
+#include "functional.h"
+namespace my_stl{
+    template <class T, class Compare = less<T>, size_t Arity = 2, class Alloc = alloc>
+    class addressable_priority_queue {
+    public:
+        typedef T value_type;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef size_t handle_type;
+    protected:
+        enum { npos = size_t(-1) };
+        vector<T, Alloc> values;          //按句柄存放的元素
+        vector<handle_type, Alloc> heap;  //堆，存放句柄
+        vector<size_type, Alloc> pos;     //句柄在堆中的下标，npos表示句柄空闲
+        vector<handle_type, Alloc> free_handles;
+        Compare comp;
+
+        bool higher(handle_type a, handle_type b) const { return comp(values[b], values[a]); }
+        void place(size_type i, handle_type h) {
+            heap[i] = h;
+            pos[h] = i;
+        }
+        void sift_up(size_type i) {
+            handle_type h = heap[i];
+            while(i > 0) {
+                size_type parent = (i - 1) / Arity;
+                if(!higher(h, heap[parent])) break;
+                place(i, heap[parent]);
+                i = parent;
+            }
+            place(i, h);
+        }
+        void sift_down(size_type i) {
+            handle_type h = heap[i];
+            size_type n = heap.size();
+            for(;;) {
+                size_type child = Arity * i + 1;
+                if(child >= n) break;
+                size_type last = child + Arity < n ? child + Arity : n;
+                size_type best = child;
+                for(size_type j = child + 1; j < last; ++j)
+                    if(higher(heap[j], heap[best])) best = j;
+                if(!higher(heap[best], h)) break;
+                place(i, heap[best]);
+                i = best;
+            }
+            place(i, h);
+        }
+        //把堆中下标i处的句柄删除，用堆尾的句柄补上
+        void remove_at(size_type i) {
+            handle_type h = heap[i];
+            handle_type last = heap.back();
+            heap.pop_back();
+            pos[h] = npos;
+            free_handles.push_back(h);
+            if(h != last) {
+                place(i, last);
+                sift_up(i);
+                sift_down(pos[last]);
+            }
+        }
+    public:
+        addressable_priority_queue() : comp() {}
+        explicit addressable_priority_queue(const Compare& x) : comp(x) {}
+
+        bool empty() const { return heap.empty(); }
+        size_type size() const { return heap.size(); }
+        const_reference top() const { return values[heap[0]]; }
+        handle_type top_handle() const { return heap[0]; }
+        //句柄h所指的元素
+        const_reference value(handle_type h) const { return values[h]; }
+        bool contains(handle_type h) const { return h < pos.size() && pos[h] != size_type(npos); }
+
+        handle_type push(const value_type& x) {
+            handle_type h;
+            if(!free_handles.empty()) {
+                h = free_handles.back();
+                free_handles.pop_back();
+                values[h] = x;
+            }else {
+                h = values.size();
+                values.push_back(x);
+                pos.push_back(size_type(npos));
+            }
+            heap.push_back(h);
+            pos[h] = heap.size() - 1;
+            sift_up(heap.size() - 1);
+            return h;
+        }
+        void pop() { remove_at(0); }
+        //把句柄h所指元素的值改为x，按优先级变高或变低上浮或下沉
+        void update(handle_type h, const value_type& x) {
+            bool up = comp(values[h], x);
+            values[h] = x;
+            if(up) sift_up(pos[h]);
+            else sift_down(pos[h]);
+        }
+        void erase(handle_type h) { remove_at(pos[h]); }
+        //清除所有元素，之前的句柄全部失效
+        void clear() {
+            values.clear();
+            heap.clear();
+            pos.clear();
+            free_handles.clear();
+        }
+    };
+}
+#endif //MY_STL_ADDRESSABLE_PRIORITY_QUEUE_H
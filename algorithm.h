@@ -0,0 +1,395 @@
+#ifndef MY_STL_ALGORITHM_H
+#define MY_STL_ALGORITHM_H
+//基本算法(copy/fill/swap/max等)与sort
+//copy、copy_backward按迭代器类型分派：原生指针且元素有trivial assignment operator时直接memmove，
+//random access iterator以个数n控制循环(比较整数比比较迭代器快)，其余逐个赋值
+//sort为pattern-defeating quicksort：中位数选轴、小区间插入排序、检测到已分割的区间时尝试以插入排序收尾，
+//不平衡的分割过多时打乱元素并最终退化为heap.h的堆排序，保证O(n log n)
+#include <cstring>
+#include <cstddef>
+#include "iterator.h"
+#include "type_traits.h"
+#include "functional.h"
+#include "heap.h"
+namespace my_stl{
+    template <class T>
+    inline const T& max(const T& a, const T& b) {
+        return a < b ? b : a;
+    }
+    template <class T, class Compare>
+    inline const T& max(const T& a, const T& b, Compare comp) {
+        return comp(a, b) ? b : a;
+    }
+    template <class T>
+    inline const T& min(const T& a, const T& b) {
+        return b < a ? b : a;
+    }
+    template <class T, class Compare>
+    inline const T& min(const T& a, const T& b, Compare comp) {
+        return comp(b, a) ? b : a;
+    }
+
+    template <class T>
+    inline void swap(T& a, T& b) {
+        T tmp = a;
+        a = b;
+        b = tmp;
+    }
+    template <class ForwardIterator1, class ForwardIterator2, class T>
+    inline void _iter_swap(ForwardIterator1 a, ForwardIterator2 b, T*) {
+        T tmp = *a;
+        *a = *b;
+        *b = tmp;
+    }
+    //交换两个迭代器所指的元素
+    template <class ForwardIterator1, class ForwardIterator2>
+    inline void iter_swap(ForwardIterator1 a, ForwardIterator2 b) {
+        _iter_swap(a, b, value_type(a));
+    }
+
+    //copy
+    template <class InputIterator, class OutputIterator>
+    inline OutputIterator _copy(InputIterator first, InputIterator last, OutputIterator result, input_iterator_tag) {
+        for(; first != last; ++result, ++first)
+            *result = *first;
+        return result;
+    }
+    template <class RandomAccessIterator, class OutputIterator, class Distance>
+    inline OutputIterator _copy_d(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result, Distance*) {
+        for(Distance n = last - first; n > 0; --n, ++result, ++first)
+            *result = *first;
+        return result;
+    }
+    template <class RandomAccessIterator, class OutputIterator>
+    inline OutputIterator _copy(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result, random_access_iterator_tag) {
+        return _copy_d(first, last, result, distance_type(first));
+    }
+    //原生指针：有trivial assignment operator时memmove，区间重叠也安全
+    template <class T>
+    inline T* _copy_t(const T* first, const T* last, T* result, _true_type) {
+        const ptrdiff_t n = last - first;
+        if(n > 0) memmove(result, first, sizeof(T) * n);
+        return result + n;
+    }
+    template <class T>
+    inline T* _copy_t(const T* first, const T* last, T* result, _false_type) {
+        return _copy_d(first, last, result, (ptrdiff_t*) 0);
+    }
+    //函数模板不能偏特化，借class template的偏特化区分原生指针
+    template <class InputIterator, class OutputIterator>
+    struct _copy_dispatch {
+        OutputIterator operator() (InputIterator first, InputIterator last, OutputIterator result) {
+            return _copy(first, last, result, iterator_category(first));
+        }
+    };
+    template <class T>
+    struct _copy_dispatch<T*, T*> {
+        T* operator() (T* first, T* last, T* result) {
+            typedef typename _type_traits<T>::has_trivial_assignment_operator t;
+            return _copy_t(first, last, result, t());
+        }
+    };
+    template <class T>
+    struct _copy_dispatch<const T*, T*> {
+        T* operator() (const T* first, const T* last, T* result) {
+            typedef typename _type_traits<T>::has_trivial_assignment_operator t;
+            return _copy_t(first, last, result, t());
+        }
+    };
+    //把[first, last)复制到[result, result + (last - first))，返回result + (last - first)
+    template <class InputIterator, class OutputIterator>
+    inline OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result) {
+        return _copy_dispatch<InputIterator, OutputIterator>()(first, last, result);
+    }
+
+    //copy_backward：从后往前复制到以result为尾的区间，返回目的区间的头；目的区间的尾可以落在[first, last)中
+    template <class BidirectionalIterator1, class BidirectionalIterator2>
+    inline BidirectionalIterator2 _copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                                 BidirectionalIterator2 result, bidirectional_iterator_tag) {
+        while(first != last)
+            *--result = *--last;
+        return result;
+    }
+    template <class RandomAccessIterator, class BidirectionalIterator, class Distance>
+    inline BidirectionalIterator _copy_backward_d(RandomAccessIterator first, RandomAccessIterator last,
+                                                  BidirectionalIterator result, Distance*) {
+        for(Distance n = last - first; n > 0; --n)
+            *--result = *--last;
+        return result;
+    }
+    template <class RandomAccessIterator, class BidirectionalIterator>
+    inline BidirectionalIterator _copy_backward(RandomAccessIterator first, RandomAccessIterator last,
+                                                BidirectionalIterator result, random_access_iterator_tag) {
+        return _copy_backward_d(first, last, result, distance_type(first));
+    }
+    template <class T>
+    inline T* _copy_backward_t(const T* first, const T* last, T* result, _true_type) {
+        const ptrdiff_t n = last - first;
+        if(n > 0) memmove(result - n, first, sizeof(T) * n);
+        return result - n;
+    }
+    template <class T>
+    inline T* _copy_backward_t(const T* first, const T* last, T* result, _false_type) {
+        return _copy_backward_d(first, last, result, (ptrdiff_t*) 0);
+    }
+    template <class BidirectionalIterator1, class BidirectionalIterator2>
+    struct _copy_backward_dispatch {
+        BidirectionalIterator2 operator() (BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                           BidirectionalIterator2 result) {
+            return _copy_backward(first, last, result, iterator_category(first));
+        }
+    };
+    template <class T>
+    struct _copy_backward_dispatch<T*, T*> {
+        T* operator() (T* first, T* last, T* result) {
+            typedef typename _type_traits<T>::has_trivial_assignment_operator t;
+            return _copy_backward_t(first, last, result, t());
+        }
+    };
+    template <class T>
+    struct _copy_backward_dispatch<const T*, T*> {
+        T* operator() (const T* first, const T* last, T* result) {
+            typedef typename _type_traits<T>::has_trivial_assignment_operator t;
+            return _copy_backward_t(first, last, result, t());
+        }
+    };
+    template <class BidirectionalIterator1, class BidirectionalIterator2>
+    inline BidirectionalIterator2 copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                                BidirectionalIterator2 result) {
+        return _copy_backward_dispatch<BidirectionalIterator1, BidirectionalIterator2>()(first, last, result);
+    }
+
+    //fill
+    template <class ForwardIterator, class T>
+    inline void fill(ForwardIterator first, ForwardIterator last, const T& value) {
+        for(; first != last; ++first)
+            *first = value;
+    }
+    //单字节类型直接memset
+    inline void fill(unsigned char* first, unsigned char* last, const unsigned char& c) {
+        if(first != last) memset(first, c, last - first);
+    }
+    inline void fill(signed char* first, signed char* last, const signed char& c) {
+        if(first != last) memset(first, static_cast<unsigned char>(c), last - first);
+    }
+    inline void fill(char* first, char* last, const char& c) {
+        if(first != last) memset(first, static_cast<unsigned char>(c), last - first);
+    }
+    //返回first + n
+    template <class OutputIterator, class Size, class T>
+    inline OutputIterator fill_n(OutputIterator first, Size n, const T& value) {
+        for(; n > 0; --n, ++first)
+            *first = value;
+        return first;
+    }
+
+    //sort
+    enum {
+        _pdq_insertion_sort_threshold = 24,  //小于此长度用插入排序
+        _pdq_ninther_threshold = 128,        //大于此长度用九数取中选轴
+        _pdq_partial_insertion_sort_limit = 8 //尝试插入排序收尾时，最多容忍移动的元素个数
+    };
+    //floor(log2(n))
+    template <class Size>
+    inline int _lg(Size n) {
+        int k = 0;
+        for(; n > 1; n >>= 1)
+            ++k;
+        return k;
+    }
+    template <class RandomAccessIterator, class T, class Compare>
+    void _insertion_sort(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+        if(first == last) return;
+        for(RandomAccessIterator i = first + 1; i != last; ++i) {
+            RandomAccessIterator j = i;
+            RandomAccessIterator k = i - 1;
+            //先比较一次，已在正确位置的元素不必搬动
+            if(comp(*j, *k)) {
+                T value = *j;
+                do {
+                    *j-- = *k;
+                } while(j != first && comp(value, *--k));
+                *j = value;
+            }
+        }
+    }
+    //*(first - 1)不大于[first, last)中的任何元素，可以省去边界检查
+    template <class RandomAccessIterator, class T, class Compare>
+    void _unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+        if(first == last) return;
+        for(RandomAccessIterator i = first + 1; i != last; ++i) {
+            RandomAccessIterator j = i;
+            RandomAccessIterator k = i - 1;
+            if(comp(*j, *k)) {
+                T value = *j;
+                do {
+                    *j-- = *k;
+                } while(comp(value, *--k));
+                *j = value;
+            }
+        }
+    }
+    //插入排序，但移动的元素超过限度就放弃并返回false；用于几乎有序的区间
+    template <class RandomAccessIterator, class T, class Compare>
+    bool _partial_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+        if(first == last) return true;
+        ptrdiff_t moved = 0;
+        for(RandomAccessIterator i = first + 1; i != last; ++i) {
+            RandomAccessIterator j = i;
+            RandomAccessIterator k = i - 1;
+            if(comp(*j, *k)) {
+                T value = *j;
+                do {
+                    *j-- = *k;
+                } while(j != first && comp(value, *--k));
+                *j = value;
+                moved += i - j;
+            }
+            if(moved > _pdq_partial_insertion_sort_limit) return false;
+        }
+        return true;
+    }
+    template <class RandomAccessIterator, class T, class Compare>
+    inline void _sort3(RandomAccessIterator a, RandomAccessIterator b, RandomAccessIterator c, T*, Compare comp) {
+        if(comp(*b, *a)) _iter_swap(a, b, (T*) 0);
+        if(comp(*c, *b)) _iter_swap(b, c, (T*) 0);
+        if(comp(*b, *a)) _iter_swap(a, b, (T*) 0);
+    }
+    //以*first为轴分割，与轴相等的元素放在右边；返回轴的最终位置
+    //partitioned表示区间原本就已分割好(没有交换任何元素)
+    //要求轴至少是三个元素的中位数，保证两个方向的扫描都不会越界
+    template <class RandomAccessIterator, class T, class Compare>
+    RandomAccessIterator _partition_right(RandomAccessIterator first, RandomAccessIterator last, T*,
+                                          Compare comp, bool& partitioned) {
+        T pivot = *first;
+        RandomAccessIterator i = first;
+        RandomAccessIterator j = last;
+        while(comp(*++i, pivot));
+        //i前面没有元素时，向左的扫描须检查边界
+        if(i - 1 == first)
+            while(i < j && !comp(*--j, pivot));
+        else
+            while(!comp(*--j, pivot));
+        partitioned = !(i < j);
+        //之后交换过的元素充当哨兵
+        while(i < j) {
+            _iter_swap(i, j, (T*) 0);
+            while(comp(*++i, pivot));
+            while(!comp(*--j, pivot));
+        }
+        RandomAccessIterator pivot_pos = i - 1;
+        *first = *pivot_pos;
+        *pivot_pos = pivot;
+        return pivot_pos;
+    }
+    //与轴相等的元素放在左边；用于大量重复元素，此时左边一段全部相等，不必再排序
+    template <class RandomAccessIterator, class T, class Compare>
+    RandomAccessIterator _partition_left(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+        T pivot = *first;
+        RandomAccessIterator i = first;
+        RandomAccessIterator j = last;
+        while(comp(pivot, *--j));
+        if(j + 1 == last)
+            while(i < j && !comp(pivot, *++i));
+        else
+            while(!comp(pivot, *++i));
+        while(i < j) {
+            _iter_swap(i, j, (T*) 0);
+            while(comp(pivot, *--j));
+            while(!comp(pivot, *++i));
+        }
+        *first = *j;
+        *j = pivot;
+        return j;
+    }
+    //左半递归，右半循环；leftmost为false时*(first - 1)是上一次分割的轴，不大于区间内任何元素
+    //bad_allowed为还允许的不平衡分割次数，用完即改用堆排序
+    template <class RandomAccessIterator, class T, class Compare>
+    void _pdqsort_loop(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp,
+                       int bad_allowed, bool leftmost) {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+        while(true) {
+            Distance len = last - first;
+            if(len < Distance(_pdq_insertion_sort_threshold)) {
+                if(leftmost) _insertion_sort(first, last, (T*) 0, comp);
+                else _unguarded_insertion_sort(first, last, (T*) 0, comp);
+                return;
+            }
+            //三数取中，长区间用九数取中；选出的轴放到*first
+            Distance half = len / 2;
+            if(len > Distance(_pdq_ninther_threshold)) {
+                _sort3(first, first + half, last - 1, (T*) 0, comp);
+                _sort3(first + 1, first + (half - 1), last - 2, (T*) 0, comp);
+                _sort3(first + 2, first + (half + 1), last - 3, (T*) 0, comp);
+                _sort3(first + (half - 1), first + half, first + (half + 1), (T*) 0, comp);
+                _iter_swap(first, first + half, (T*) 0);
+            }else {
+                _sort3(first + half, first, last - 1, (T*) 0, comp);
+            }
+            //轴等于左侧的边界元素：区间中没有比它小的元素，把与它相等的一次全部分到左边
+            if(!leftmost && !comp(*(first - 1), *first)) {
+                first = _partition_left(first, last, (T*) 0, comp) + 1;
+                continue;
+            }
+            bool partitioned;
+            RandomAccessIterator pivot_pos = _partition_right(first, last, (T*) 0, comp, partitioned);
+            Distance l_len = pivot_pos - first;
+            Distance r_len = last - (pivot_pos + 1);
+            if(l_len < len / 8 || r_len < len / 8) {
+                //分割很不平衡
+                if(--bad_allowed == 0) {
+                    make_heap<2>(first, last, comp);
+                    sort_heap<2>(first, last, comp);
+                    return;
+                }
+                //交换几个位置固定的元素，打破造成坏分割的模式
+                if(l_len >= Distance(_pdq_insertion_sort_threshold)) {
+                    _iter_swap(first, first + l_len / 4, (T*) 0);
+                    _iter_swap(pivot_pos - 1, pivot_pos - l_len / 4, (T*) 0);
+                    if(l_len > Distance(_pdq_ninther_threshold)) {
+                        _iter_swap(first + 1, first + (l_len / 4 + 1), (T*) 0);
+                        _iter_swap(first + 2, first + (l_len / 4 + 2), (T*) 0);
+                        _iter_swap(pivot_pos - 2, pivot_pos - (l_len / 4 + 1), (T*) 0);
+                        _iter_swap(pivot_pos - 3, pivot_pos - (l_len / 4 + 2), (T*) 0);
+                    }
+                }
+                if(r_len >= Distance(_pdq_insertion_sort_threshold)) {
+                    _iter_swap(pivot_pos + 1, pivot_pos + (1 + r_len / 4), (T*) 0);
+                    _iter_swap(last - 1, last - r_len / 4, (T*) 0);
+                    if(r_len > Distance(_pdq_ninther_threshold)) {
+                        _iter_swap(pivot_pos + 2, pivot_pos + (2 + r_len / 4), (T*) 0);
+                        _iter_swap(pivot_pos + 3, pivot_pos + (3 + r_len / 4), (T*) 0);
+                        _iter_swap(last - 2, last - (1 + r_len / 4), (T*) 0);
+                        _iter_swap(last - 3, last - (2 + r_len / 4), (T*) 0);
+                    }
+                }
+            }else if(partitioned && _partial_insertion_sort(first, pivot_pos, (T*) 0, comp)
+                                 && _partial_insertion_sort(pivot_pos + 1, last, (T*) 0, comp)) {
+                //原本已分割好，两边也几乎有序：插入排序直接收尾，有序输入因此是O(n)
+                return;
+            }
+            _pdqsort_loop(first, pivot_pos, (T*) 0, comp, bad_allowed, leftmost);
+            first = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+    template <class RandomAccessIterator, class T, class Compare>
+    inline void _sort(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+        if(first == last) return;
+        _pdqsort_loop(first, last, (T*) 0, comp, _lg(last - first), true);
+    }
+    template <class RandomAccessIterator, class T>
+    inline void _sort(RandomAccessIterator first, RandomAccessIterator last, T*) {
+        _sort(first, last, (T*) 0, less<T>());
+    }
+    //不稳定排序，O(n log n)
+    template <class RandomAccessIterator, class Compare>
+    inline void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        _sort(first, last, value_type(first), comp);
+    }
+    template <class RandomAccessIterator>
+    inline void sort(RandomAccessIterator first, RandomAccessIterator last) {
+        _sort(first, last, value_type(first));
+    }
+}
+#endif //MY_STL_ALGORITHM_H
@@ -23,7 +23,7 @@ namespace my_stl {
             return result;
         }
 
-        static void *deallocate(void *p, size_t n) {
+        static void deallocate(void *p, size_t n) {
             free(p); //第一级配置使用free();
         }
 
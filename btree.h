@@ -0,0 +1,683 @@
+#ifndef MY_STL_BTREE_H
+#define MY_STL_BTREE_H
+//B+树：元素全部存放在叶节点中，叶节点之间双向链接，内部节点只存放分隔键和子节点指针
+//一个节点约占NodeBytes字节(默认256，即4条cache line)，一次查找只访问O(log_B n)个节点
+//节点内先二分缩小范围，再顺序扫描连续存放的键
+//插入、删除会移动同一节点内的元素，所以会使指向该节点的迭代器失效
+#include <cstddef>
+#include "iterator.h"
+#include "alloc.h"
+#include "cons.h"
+#include "pair.h"
+namespace my_stl{
+    struct _btree_node_base {
+        bool is_leaf;
+        size_t count; //叶节点为元素个数，内部节点为键的个数(子节点比键多一个)
+    };
+    template <class Value, size_t Cap>
+    struct _btree_leaf : public _btree_node_base {
+        _btree_leaf* prev;
+        _btree_leaf* next;
+        alignas(Value) unsigned char storage[sizeof(Value) * Cap];
+        Value* values() { return reinterpret_cast<Value*>(storage); }
+    };
+    template <class Key, size_t Cap>
+    struct _btree_internal : public _btree_node_base {
+        _btree_node_base* children[Cap + 1];
+        alignas(Key) unsigned char storage[sizeof(Key) * Cap];
+        Key* keys() { return reinterpret_cast<Key*>(storage); }
+    };
+
+    //迭代器：叶节点 + 节点内下标，沿叶节点链表移动；end()为(最后一个叶节点, 其元素个数)
+    template <class Value, class Ref, class Ptr, size_t Cap>
+    struct _btree_iterator {
+        typedef _btree_iterator<Value, Value&, Value*, Cap> iterator;
+        typedef _btree_iterator<Value, Ref, Ptr, Cap> self;
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _btree_leaf<Value, Cap>* leaf_ptr;
+
+        leaf_ptr leaf;
+        size_t index;
+
+        _btree_iterator() {}
+        _btree_iterator(leaf_ptr l, size_t i) : leaf(l), index(i) {}
+        _btree_iterator(const iterator& x) : leaf(x.leaf), index(x.index) {}
+        //对iterator而言上面是复制构造函数，复制赋值也要一并声明
+        self& operator= (const iterator& x) {
+            leaf = x.leaf;
+            index = x.index;
+            return *this;
+        }
+
+        bool operator== (const self& x) const { return leaf == x.leaf && index == x.index; }
+        bool operator!= (const self& x) const { return !(*this == x); }
+        reference operator*() const { return leaf -> values()[index]; }
+        pointer operator->() const { return &(operator*()); }
+        self& operator++() {
+            if(++index == leaf -> count && leaf -> next) {
+                leaf = leaf -> next;
+                index = 0;
+            }
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--() {
+            if(index == 0) {
+                leaf = leaf -> prev;
+                index = leaf -> count;
+            }
+            --index;
+            return *this;
+        }
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+    };
+
+    //键值唯一的B+树，btree_set与btree_map的底层
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc = alloc, size_t NodeBytes = 256>
+    class btree {
+    public:
+        enum { leaf_capacity = (NodeBytes - 4 * sizeof(void*)) / sizeof(Value) >= 4 ?
+                               (NodeBytes - 4 * sizeof(void*)) / sizeof(Value) : 4 };
+        enum { internal_capacity = (NodeBytes - 3 * sizeof(void*)) / (sizeof(Key) + sizeof(void*)) >= 4 ?
+                                   (NodeBytes - 3 * sizeof(void*)) / (sizeof(Key) + sizeof(void*)) : 4 };
+        typedef Key key_type;
+        typedef Value value_type;
+        typedef value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _btree_iterator<Value, Value&, Value*, leaf_capacity> iterator;
+        typedef _btree_iterator<Value, const Value&, const Value*, leaf_capacity> const_iterator;
+    protected:
+        typedef _btree_node_base* node_ptr;
+        typedef _btree_leaf<Value, leaf_capacity> leaf_node;
+        typedef _btree_internal<Key, internal_capacity> internal_node;
+        typedef my_alloc<leaf_node, Alloc> leaf_allocator;
+        typedef my_alloc<internal_node, Alloc> internal_allocator;
+        typedef my_alloc<node_ptr, Alloc> node_ptr_allocator;
+        //非根节点的最少元素(键)个数；顺序追加产生的最后一个叶节点可以暂时少于此数
+        enum { _min_leaf = leaf_capacity / 2 };
+        enum { _min_internal = internal_capacity / 2 };
+        //节点内二分到不超过这么多个元素后改为顺序扫描
+        enum { _linear_search_threshold = 16 };
+        enum { _max_height = 64 };
+        //从根到叶的路径：经过的内部节点及所走的子节点下标
+        struct path_entry {
+            internal_node* node;
+            size_t index;
+        };
+
+        node_ptr root;
+        leaf_node* first_leaf;
+        leaf_node* last_leaf;
+        size_type node_count; //元素个数
+        Compare key_compare;
+
+        static leaf_node* as_leaf(node_ptr p) { return static_cast<leaf_node*>(p); }
+        static internal_node* as_internal(node_ptr p) { return static_cast<internal_node*>(p); }
+        static const Key& key_of(const Value& v) { return KeyOfValue()(v); }
+
+        leaf_node* create_leaf() {
+            leaf_node* p = leaf_allocator::allocate();
+            p -> is_leaf = true;
+            p -> count = 0;
+            p -> prev = p -> next = 0;
+            return p;
+        }
+        internal_node* create_internal() {
+            internal_node* p = internal_allocator::allocate();
+            p -> is_leaf = false;
+            p -> count = 0;
+            return p;
+        }
+        //销毁以p为根的子树
+        void destroy_subtree(node_ptr p) {
+            if(p -> is_leaf) {
+                leaf_node* l = as_leaf(p);
+                for(size_t i = 0; i != l -> count; ++i)
+                    destroy(&l -> values()[i]);
+                leaf_allocator::deallocate(l);
+            }else {
+                internal_node* n = as_internal(p);
+                for(size_t i = 0; i <= n -> count; ++i)
+                    destroy_subtree(n -> children[i]);
+                for(size_t i = 0; i != n -> count; ++i)
+                    destroy(&n -> keys()[i]);
+                internal_allocator::deallocate(n);
+            }
+        }
+        //把a[first, n)向后移动一格；元素可能不可赋值(例如pair<const Key, T>)，逐个复制构造再析构
+        template <class T>
+        static void shift_right(T* a, size_t first, size_t n) {
+            for(size_t i = n; i > first; --i) {
+                construct(&a[i], a[i - 1]);
+                destroy(&a[i - 1]);
+            }
+        }
+        //把a[first + 1, n)向前移动一格，a[first]必须已经析构
+        template <class T>
+        static void shift_left(T* a, size_t first, size_t n) {
+            for(size_t i = first; i + 1 < n; ++i) {
+                construct(&a[i], a[i + 1]);
+                destroy(&a[i + 1]);
+            }
+        }
+        //把from[first, from_n)移到to[to_n, ...)
+        template <class T>
+        static void move_range(T* from, size_t first, size_t from_n, T* to, size_t to_n) {
+            for(size_t i = first; i != from_n; ++i, ++to_n) {
+                construct(&to[to_n], from[i]);
+                destroy(&from[i]);
+            }
+        }
+
+        //叶节点内第一个键值不小于k的位置
+        size_t leaf_lower(leaf_node* l, const Key& k) const {
+            const Value* v = l -> values();
+            size_t lo = 0, hi = l -> count;
+            while(hi - lo > size_t(_linear_search_threshold)) {
+                size_t mid = lo + (hi - lo) / 2;
+                if(key_compare(key_of(v[mid]), k)) lo = mid + 1;
+                else hi = mid;
+            }
+            while(lo < hi && key_compare(key_of(v[lo]), k))
+                ++lo;
+            return lo;
+        }
+        //叶节点内第一个键值大于k的位置
+        size_t leaf_upper(leaf_node* l, const Key& k) const {
+            const Value* v = l -> values();
+            size_t lo = 0, hi = l -> count;
+            while(hi - lo > size_t(_linear_search_threshold)) {
+                size_t mid = lo + (hi - lo) / 2;
+                if(!key_compare(k, key_of(v[mid]))) lo = mid + 1;
+                else hi = mid;
+            }
+            while(lo < hi && !key_compare(k, key_of(v[lo])))
+                ++lo;
+            return lo;
+        }
+        //内部节点中k所在的子节点：keys[i]是children[i + 1]中最小的键，等于分隔键时走右边
+        size_t child_index(internal_node* n, const Key& k) const {
+            const Key* keys = n -> keys();
+            size_t lo = 0, hi = n -> count;
+            while(hi - lo > size_t(_linear_search_threshold)) {
+                size_t mid = lo + (hi - lo) / 2;
+                if(!key_compare(k, keys[mid])) lo = mid + 1;
+                else hi = mid;
+            }
+            while(lo < hi && !key_compare(k, keys[lo]))
+                ++lo;
+            return lo;
+        }
+        //找到k所在的叶节点，path不为0时记录路径，depth为路径长度
+        leaf_node* descend(const Key& k, path_entry* path, size_t& depth) const {
+            node_ptr p = root;
+            depth = 0;
+            while(!p -> is_leaf) {
+                internal_node* n = as_internal(p);
+                size_t i = child_index(n, k);
+                if(path) {
+                    path[depth].node = n;
+                    path[depth].index = i;
+                }
+                ++depth;
+                p = n -> children[i];
+            }
+            return as_leaf(p);
+        }
+        //以p为根的子树中最小的键
+        static const Key& min_key(node_ptr p) {
+            while(!p -> is_leaf)
+                p = as_internal(p) -> children[0];
+            return key_of(as_leaf(p) -> values()[0]);
+        }
+        //建树时一层中下一个节点取多少个元素(子节点)：尽量取满cap个，剩下的不够再凑一个下限为lower的节点时与之平分
+        static size_t bulk_take(size_t remaining, size_t cap, size_t lower) {
+            if(remaining > cap && remaining - cap < lower) return remaining / 2;
+            return remaining < cap ? remaining : cap;
+        }
+        //(l, i)落在叶节点末尾时挪到下一个叶节点的开头
+        static iterator make_iterator(leaf_node* l, size_t i) {
+            if(i == l -> count && l -> next)
+                return iterator(l -> next, 0);
+            return iterator(l, i);
+        }
+
+        //把分隔键k和它右边的子节点right插入path[depth - 1]所指的内部节点，必要时逐层分裂
+        void insert_into_parent(path_entry* path, size_t depth, node_ptr left, const Key& k, node_ptr right) {
+            if(depth == 0) {
+                internal_node* r = create_internal();
+                construct(&r -> keys()[0], k);
+                r -> children[0] = left;
+                r -> children[1] = right;
+                r -> count = 1;
+                root = r;
+                return;
+            }
+            internal_node* n = path[depth - 1].node;
+            size_t pos = path[depth - 1].index;
+            if(n -> count < size_t(internal_capacity)) {
+                insert_in_internal(n, pos, k, right);
+                return;
+            }
+            //分裂：连同k共internal_capacity + 1个键，左边留m个，第m个上移，其余归新节点
+            size_t m = (n -> count + 1) / 2;
+            internal_node* sibling = create_internal();
+            if(pos == m) {
+                //k本身上移，right成为新节点最左边的子节点
+                move_range(n -> keys(), m, n -> count, sibling -> keys(), 0);
+                sibling -> children[0] = right;
+                for(size_t i = m + 1; i <= n -> count; ++i)
+                    sibling -> children[i - m] = n -> children[i];
+                sibling -> count = n -> count - m;
+                n -> count = m;
+                insert_into_parent(path, depth - 1, n, k, sibling);
+                return;
+            }
+            size_t mid = pos < m ? m - 1 : m;
+            move_range(n -> keys(), mid + 1, n -> count, sibling -> keys(), 0);
+            for(size_t i = mid + 1; i <= n -> count; ++i)
+                sibling -> children[i - mid - 1] = n -> children[i];
+            sibling -> count = n -> count - mid - 1;
+            Key up = n -> keys()[mid];
+            destroy(&n -> keys()[mid]);
+            n -> count = mid;
+            if(pos <= mid) insert_in_internal(n, pos, k, right);
+            else insert_in_internal(sibling, pos - mid - 1, k, right);
+            insert_into_parent(path, depth - 1, n, up, sibling);
+        }
+        static void insert_in_internal(internal_node* n, size_t pos, const Key& k, node_ptr right) {
+            shift_right(n -> keys(), pos, n -> count);
+            construct(&n -> keys()[pos], k);
+            for(size_t i = n -> count + 1; i > pos + 1; --i)
+                n -> children[i] = n -> children[i - 1];
+            n -> children[pos + 1] = right;
+            ++n -> count;
+        }
+        //从内部节点中删除keys[pos]及其右边的子节点
+        static void erase_in_internal(internal_node* n, size_t pos) {
+            destroy(&n -> keys()[pos]);
+            shift_left(n -> keys(), pos, n -> count);
+            for(size_t i = pos + 1; i < n -> count; ++i)
+                n -> children[i] = n -> children[i + 1];
+            --n -> count;
+        }
+        //删除叶节点l中下标为i的元素；l不是根且元素会不足时要用到path(到l的路径，长depth)
+        void erase_at(leaf_node* l, size_t i, path_entry* path, size_t depth) {
+            destroy(&l -> values()[i]);
+            shift_left(l -> values(), i, l -> count);
+            --l -> count;
+            --node_count;
+            if(l == root) {
+                if(l -> count == 0) {
+                    leaf_allocator::deallocate(l);
+                    root = 0;
+                    first_leaf = last_leaf = 0;
+                }
+            }else if(l -> count < size_t(_min_leaf)) {
+                fix_leaf(l, path, depth);
+            }
+        }
+        void unlink_leaf(leaf_node* l) {
+            if(l -> prev) l -> prev -> next = l -> next;
+            else first_leaf = l -> next;
+            if(l -> next) l -> next -> prev = l -> prev;
+            else last_leaf = l -> prev;
+        }
+        //叶节点l(路径长depth)元素不足：向兄弟借一个，或与兄弟合并
+        void fix_leaf(leaf_node* l, path_entry* path, size_t depth) {
+            internal_node* p = path[depth - 1].node;
+            size_t c = path[depth - 1].index;
+            if(c > 0) {
+                leaf_node* left = as_leaf(p -> children[c - 1]);
+                if(left -> count > size_t(_min_leaf)) {
+                    shift_right(l -> values(), 0, l -> count);
+                    move_range(left -> values(), left -> count - 1, left -> count, l -> values(), 0);
+                    --left -> count;
+                    ++l -> count;
+                    p -> keys()[c - 1] = key_of(l -> values()[0]);
+                    return;
+                }
+            }
+            if(c < p -> count) {
+                leaf_node* right = as_leaf(p -> children[c + 1]);
+                if(right -> count > size_t(_min_leaf)) {
+                    move_range(right -> values(), 0, 1, l -> values(), l -> count);
+                    shift_left(right -> values(), 0, right -> count);
+                    --right -> count;
+                    ++l -> count;
+                    p -> keys()[c] = key_of(right -> values()[0]);
+                    return;
+                }
+            }
+            //合并：右边的节点并入左边的节点
+            leaf_node* left;
+            leaf_node* right;
+            size_t key_pos;
+            if(c > 0) {
+                left = as_leaf(p -> children[c - 1]);
+                right = l;
+                key_pos = c - 1;
+            }else {
+                left = l;
+                right = as_leaf(p -> children[c + 1]);
+                key_pos = c;
+            }
+            move_range(right -> values(), 0, right -> count, left -> values(), left -> count);
+            left -> count += right -> count;
+            unlink_leaf(right);
+            leaf_allocator::deallocate(right);
+            erase_in_internal(p, key_pos);
+            fix_internal(path, depth);
+        }
+        //path[depth - 1]所指的内部节点可能键不足
+        void fix_internal(path_entry* path, size_t depth) {
+            internal_node* n = path[depth - 1].node;
+            if(depth == 1) {
+                //根只剩一个子节点时降低树高
+                if(n -> count == 0) {
+                    root = n -> children[0];
+                    internal_allocator::deallocate(n);
+                }
+                return;
+            }
+            if(n -> count >= size_t(_min_internal)) return;
+            internal_node* p = path[depth - 2].node;
+            size_t c = path[depth - 2].index;
+            if(c > 0) {
+                internal_node* left = as_internal(p -> children[c - 1]);
+                if(left -> count > size_t(_min_internal)) {
+                    //经由父节点向右旋转一个键
+                    shift_right(n -> keys(), 0, n -> count);
+                    construct(&n -> keys()[0], p -> keys()[c - 1]);
+                    for(size_t i = n -> count + 1; i > 0; --i)
+                        n -> children[i] = n -> children[i - 1];
+                    n -> children[0] = left -> children[left -> count];
+                    ++n -> count;
+                    p -> keys()[c - 1] = left -> keys()[left -> count - 1];
+                    destroy(&left -> keys()[left -> count - 1]);
+                    --left -> count;
+                    return;
+                }
+            }
+            if(c < p -> count) {
+                internal_node* right = as_internal(p -> children[c + 1]);
+                if(right -> count > size_t(_min_internal)) {
+                    construct(&n -> keys()[n -> count], p -> keys()[c]);
+                    n -> children[n -> count + 1] = right -> children[0];
+                    ++n -> count;
+                    p -> keys()[c] = right -> keys()[0];
+                    destroy(&right -> keys()[0]);
+                    shift_left(right -> keys(), 0, right -> count);
+                    for(size_t i = 0; i < right -> count; ++i)
+                        right -> children[i] = right -> children[i + 1];
+                    --right -> count;
+                    return;
+                }
+            }
+            //合并：left + 父节点的分隔键 + right
+            internal_node* left;
+            internal_node* right;
+            size_t key_pos;
+            if(c > 0) {
+                left = as_internal(p -> children[c - 1]);
+                right = n;
+                key_pos = c - 1;
+            }else {
+                left = n;
+                right = as_internal(p -> children[c + 1]);
+                key_pos = c;
+            }
+            construct(&left -> keys()[left -> count], p -> keys()[key_pos]);
+            move_range(right -> keys(), 0, right -> count, left -> keys(), left -> count + 1);
+            for(size_t i = 0; i <= right -> count; ++i)
+                left -> children[left -> count + 1 + i] = right -> children[i];
+            left -> count += right -> count + 1;
+            internal_allocator::deallocate(right);
+            erase_in_internal(p, key_pos);
+            fix_internal(path, depth - 1);
+        }
+    public:
+        btree(const Compare& comp = Compare())
+            : root(0), first_leaf(0), last_leaf(0), node_count(0), key_compare(comp) {}
+        btree(const btree& x) : root(0), first_leaf(0), last_leaf(0), node_count(0), key_compare(x.key_compare) {
+            build_from_sorted(x.begin(), x.end());
+        }
+        btree& operator= (const btree& x) {
+            if(this != &x) {
+                btree tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        ~btree() { clear(); }
+
+        Compare key_comp() const { return key_compare; }
+        iterator begin() { return iterator(first_leaf, 0); }
+        iterator end() { return iterator(last_leaf, last_leaf ? last_leaf -> count : 0); }
+        const_iterator begin() const { return const_iterator(first_leaf, 0); }
+        const_iterator end() const { return const_iterator(last_leaf, last_leaf ? last_leaf -> count : 0); }
+        bool empty() const { return node_count == 0; }
+        size_type size() const { return node_count; }
+        size_type max_size() const { return size_type(-1); }
+
+        void swap(btree& x) {
+            node_ptr r = root; root = x.root; x.root = r;
+            leaf_node* l = first_leaf; first_leaf = x.first_leaf; x.first_leaf = l;
+            l = last_leaf; last_leaf = x.last_leaf; x.last_leaf = l;
+            size_type n = node_count; node_count = x.node_count; x.node_count = n;
+            Compare c = key_compare; key_compare = x.key_compare; x.key_compare = c;
+        }
+        void clear() {
+            if(root) destroy_subtree(root);
+            root = 0;
+            first_leaf = last_leaf = 0;
+            node_count = 0;
+        }
+
+        pair<iterator, bool> insert_unique(const value_type& v) {
+            const Key& k = key_of(v);
+            if(root == 0) {
+                leaf_node* l = create_leaf();
+                construct(&l -> values()[0], v);
+                l -> count = 1;
+                root = first_leaf = last_leaf = l;
+                node_count = 1;
+                return pair<iterator, bool>(iterator(l, 0), true);
+            }
+            path_entry path[_max_height];
+            size_t depth;
+            leaf_node* l = descend(k, path, depth);
+            size_t i = leaf_lower(l, k);
+            if(i < l -> count && !key_compare(k, key_of(l -> values()[i])))
+                return pair<iterator, bool>(make_iterator(l, i), false);
+            if(l -> count < size_t(leaf_capacity)) {
+                shift_right(l -> values(), i, l -> count);
+                construct(&l -> values()[i], v);
+                ++l -> count;
+                ++node_count;
+                return pair<iterator, bool>(iterator(l, i), true);
+            }
+            //叶节点已满，分裂；追加在最后一个叶节点末尾时(顺序插入)不搬动元素，让左边保持满载
+            leaf_node* sibling = create_leaf();
+            size_t mid = (i == l -> count && l == last_leaf) ? l -> count : l -> count / 2;
+            move_range(l -> values(), mid, l -> count, sibling -> values(), 0);
+            sibling -> count = l -> count - mid;
+            l -> count = mid;
+            sibling -> prev = l;
+            sibling -> next = l -> next;
+            if(l -> next) l -> next -> prev = sibling;
+            else last_leaf = sibling;
+            l -> next = sibling;
+            leaf_node* target = l;
+            if(i > mid || (i == mid && mid == leaf_capacity)) {
+                target = sibling;
+                i -= mid;
+            }
+            shift_right(target -> values(), i, target -> count);
+            construct(&target -> values()[i], v);
+            ++target -> count;
+            ++node_count;
+            insert_into_parent(path, depth, l, key_of(sibling -> values()[0]), sibling);
+            return pair<iterator, bool>(iterator(target, i), true);
+        }
+        //提示位置被忽略，为了与set/map的接口一致
+        iterator insert_unique(iterator, const value_type& v) { return insert_unique(v).first; }
+        template <class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            for(; first != last; ++first)
+                insert_unique(*first);
+        }
+
+        //由严格递增的区间以O(n)重建，原有元素被清除
+        //从左到右把叶节点装满，再自底向上逐层建内部节点；每层最后两个节点在必要时平分，使它们都不少于下限
+        template <class ForwardIterator>
+        void build_from_sorted(ForwardIterator first, ForwardIterator last) {
+            clear();
+            size_type n = 0; //不用distance：区间可能来自std的容器，会与std::distance发生歧义
+            for(ForwardIterator i = first; i != last; ++i)
+                ++n;
+            if(n == 0) return;
+            size_t capacity = (n + leaf_capacity - 1) / leaf_capacity;
+            node_ptr* level = node_ptr_allocator::allocate(capacity);
+            size_t nodes = 0;
+            //叶节点层
+            for(size_type remaining = n; remaining != 0; ) {
+                size_t take = bulk_take(remaining, leaf_capacity, _min_leaf);
+                leaf_node* l = create_leaf();
+                for(; l -> count != take; ++first, ++l -> count)
+                    construct(&l -> values()[l -> count], *first);
+                l -> prev = last_leaf;
+                if(last_leaf) last_leaf -> next = l;
+                else first_leaf = l;
+                last_leaf = l;
+                level[nodes++] = l;
+                remaining -= take;
+                node_count += take;
+            }
+            //内部节点层：上一层的结果就地写回level的前部
+            while(nodes > 1) {
+                size_t m = 0;
+                for(size_t used = 0; used != nodes; ) {
+                    size_t take = bulk_take(nodes - used, internal_capacity + 1, _min_internal + 1);
+                    internal_node* p = create_internal();
+                    p -> children[0] = level[used];
+                    for(size_t j = 1; j != take; ++j) {
+                        p -> children[j] = level[used + j];
+                        construct(&p -> keys()[j - 1], min_key(level[used + j]));
+                    }
+                    p -> count = take - 1;
+                    level[m++] = p;
+                    used += take;
+                }
+                nodes = m;
+            }
+            root = level[0];
+            node_ptr_allocator::deallocate(level, capacity);
+        }
+
+        size_type erase(const key_type& k) {
+            if(root == 0) return 0;
+            path_entry path[_max_height];
+            size_t depth;
+            leaf_node* l = descend(k, path, depth);
+            size_t i = leaf_lower(l, k);
+            if(i == l -> count || key_compare(k, key_of(l -> values()[i])))
+                return 0;
+            erase_at(l, i, path, depth);
+            return 1;
+        }
+        //直接删除迭代器所指的元素；只有叶节点会因此不足时，才按它的键值下降一次取得到叶节点的路径
+        void erase(iterator position) {
+            leaf_node* l = position.leaf;
+            path_entry path[_max_height];
+            size_t depth = 0;
+            if(l != root && l -> count <= size_t(_min_leaf))
+                descend(key_of(l -> values()[position.index]), path, depth);
+            erase_at(l, position.index, path, depth);
+        }
+        void erase(iterator first, iterator last) {
+            if(first == begin() && last == end()) {
+                clear();
+                return;
+            }
+            //删除会移动元素，先数出个数，再从first的键值起逐个删除
+            size_type n = 0;
+            for(iterator it = first; it != last; ++it)
+                ++n;
+            while(n--) {
+                Key k = key_of(*first);
+                erase(k);
+                first = lower_bound(k);
+            }
+        }
+
+        iterator lower_bound(const key_type& k) {
+            if(root == 0) return end();
+            size_t depth;
+            leaf_node* l = descend(k, 0, depth);
+            return make_iterator(l, leaf_lower(l, k));
+        }
+        const_iterator lower_bound(const key_type& k) const {
+            return const_cast<btree*>(this) -> lower_bound(k);
+        }
+        iterator upper_bound(const key_type& k) {
+            if(root == 0) return end();
+            size_t depth;
+            leaf_node* l = descend(k, 0, depth);
+            return make_iterator(l, leaf_upper(l, k));
+        }
+        const_iterator upper_bound(const key_type& k) const {
+            return const_cast<btree*>(this) -> upper_bound(k);
+        }
+        pair<iterator, iterator> equal_range(const key_type& k) {
+            return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+        }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+        }
+        iterator find(const key_type& k) {
+            iterator j = lower_bound(k);
+            return (j == end() || key_compare(k, key_of(*j))) ? end() : j;
+        }
+        const_iterator find(const key_type& k) const {
+            return const_cast<btree*>(this) -> find(k);
+        }
+        size_type count(const key_type& k) const { return find(k) == end() ? 0 : 1; }
+
+        friend bool operator== (const btree& x, const btree& y) {
+            if(x.size() != y.size()) return false;
+            const_iterator i = x.begin();
+            const_iterator j = y.begin();
+            for(; i != x.end(); ++i, ++j)
+                if(!(*i == *j)) return false;
+            return true;
+        }
+        friend bool operator< (const btree& x, const btree& y) {
+            const_iterator i = x.begin();
+            const_iterator j = y.begin();
+            for(; i != x.end() && j != y.end(); ++i, ++j) {
+                if(*i < *j) return true;
+                if(*j < *i) return false;
+            }
+            return i == x.end() && j != y.end();
+        }
+    };
+}
+#endif //MY_STL_BTREE_H
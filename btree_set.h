@@ -0,0 +1,73 @@
+#ifndef MY_STL_BTREE_SET_H
+#define MY_STL_BTREE_SET_H
+//btree_set：接口与set相同，以B+树为底层；插入删除会使同一叶节点上的迭代器失效
+#include "btree.h"
+#include "functional.h"
+namespace my_stl{
+    template <class Key, class Compare = less<Key>, class Alloc = alloc>
+    class btree_set {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+    protected:
+        typedef btree<key_type, value_type, identity<value_type>, key_compare, Alloc> rep_type;
+        rep_type t;
+    public:
+        typedef typename rep_type::const_pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::const_reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        //不允许通过迭代器改变元素值，iterator也是const_iterator
+        typedef typename rep_type::const_iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+
+        btree_set() : t(Compare()) {}
+        explicit btree_set(const Compare& comp) : t(comp) {}
+        template <class InputIterator>
+        btree_set(InputIterator first, InputIterator last) : t(Compare()) { t.insert_unique(first, last); }
+        template <class InputIterator>
+        btree_set(InputIterator first, InputIterator last, const Compare& comp) : t(comp) { t.insert_unique(first, last); }
+
+        key_compare key_comp() const { return t.key_comp(); }
+        value_compare value_comp() const { return t.key_comp(); }
+        iterator begin() const { return t.begin(); }
+        iterator end() const { return t.end(); }
+        bool empty() const { return t.empty(); }
+        size_type size() const { return t.size(); }
+        size_type max_size() const { return t.max_size(); }
+        void swap(btree_set& x) { t.swap(x.t); }
+
+        pair<iterator, bool> insert(const value_type& x) {
+            pair<typename rep_type::iterator, bool> p = t.insert_unique(x);
+            return pair<iterator, bool>(p.first, p.second);
+        }
+        iterator insert(iterator position, const value_type& x) {
+            return t.insert_unique((typename rep_type::iterator&) position, x);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) { t.insert_unique(first, last); }
+        void erase(iterator position) { t.erase((typename rep_type::iterator&) position); }
+        size_type erase(const key_type& x) { return t.erase(x); }
+        void erase(iterator first, iterator last) {
+            t.erase((typename rep_type::iterator&) first, (typename rep_type::iterator&) last);
+        }
+        void clear() { t.clear(); }
+        //由已排序的区间以O(n)重建，原有元素被清除
+        template <class ForwardIterator>
+        void build_from_sorted(ForwardIterator first, ForwardIterator last) { t.build_from_sorted(first, last); }
+
+        iterator find(const key_type& x) const { return t.find(x); }
+        size_type count(const key_type& x) const { return t.count(x); }
+        iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+        iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+        pair<iterator, iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+        friend bool operator== (const btree_set& x, const btree_set& y) { return x.t == y.t; }
+        friend bool operator< (const btree_set& x, const btree_set& y) { return x.t < y.t; }
+    };
+}
+#endif //MY_STL_BTREE_SET_H
@@ -0,0 +1,183 @@
+#ifndef MY_STL_CHANNEL_H
+#define MY_STL_CHANNEL_H
+//协程通道，建立在queue之上
+//co_await ch.push(x)：有等待中的消费者时直接交给它，否则放入缓冲区；缓冲区满则挂起当前协程
+//co_await ch.pop()  ：缓冲区有数据就取走，否则挂起当前协程；通道关闭且已取空时得到空的optional
+//被唤醒的协程交给通道所属的执行器恢复，挂起期间不占用线程
+//capacity为0时是无缓冲的会合通道，channel::unbounded表示不限容量
+//协程可能在不同的工作线程上恢复，而alloc不是线程安全的，缓冲区默认用mt_alloc
+#include <coroutine>
+#include <optional>
+#include <mutex>
+#include <utility>
+#include <cstddef>
+#include "deque.h"
+#include "mt_alloc.h"
+#include "queue.h"
+#include "executor.h"
+namespace my_stl{
+    template <class T, class Sequence = deque<T, mt_alloc> >
+    class channel {
+    public:
+        typedef T value_type;
+        typedef size_t size_type;
+        static const size_type unbounded = size_type(-1);
+
+        class push_awaiter;
+        class pop_awaiter;
+    protected:
+        queue<T, Sequence> items;
+        size_type cap;
+        bool closed;
+        std::mutex m;
+        _executor_ref exec;
+        //挂起的生产者、消费者，各自按FIFO排队
+        push_awaiter* push_head;
+        push_awaiter* push_tail;
+        pop_awaiter* pop_head;
+        pop_awaiter* pop_tail;
+
+        template <class W>
+        static void enqueue(W*& head, W*& tail, W* w) {
+            w->next = 0;
+            if(tail) tail->next = w;
+            else head = w;
+            tail = w;
+        }
+        template <class W>
+        static W* dequeue(W*& head, W*& tail) {
+            W* w = head;
+            if(w) {
+                head = w->next;
+                if(head == 0) tail = 0;
+            }
+            return w;
+        }
+        //返回true表示已挂起
+        bool suspend_push(push_awaiter* w) {
+            std::coroutine_handle<> wake;
+            {
+                std::lock_guard<std::mutex> g(m);
+                if(closed) {
+                    w->ok = false;
+                    return false;
+                }
+                if(pop_awaiter* q = dequeue(pop_head, pop_tail)) {
+                    //直接交接，不经过缓冲区
+                    q->result.emplace(std::move(w->value));
+                    wake = q->h;
+                }else if(items.size() < cap) {
+                    items.push(w->value);
+                }else {
+                    enqueue(push_head, push_tail, w);
+                    return true;
+                }
+                w->ok = true;
+            }
+            if(wake) exec.schedule(wake);
+            return false;
+        }
+        bool suspend_pop(pop_awaiter* w) {
+            std::coroutine_handle<> wake;
+            {
+                std::lock_guard<std::mutex> g(m);
+                if(!items.empty()) {
+                    w->result.emplace(std::move(items.front()));
+                    items.pop();
+                    //腾出了一个位置，放进一个挂起的生产者
+                    if(push_awaiter* p = dequeue(push_head, push_tail)) {
+                        items.push(p->value);
+                        p->ok = true;
+                        wake = p->h;
+                    }
+                }else if(push_awaiter* p = dequeue(push_head, push_tail)) {
+                    //无缓冲通道的会合
+                    w->result.emplace(std::move(p->value));
+                    p->ok = true;
+                    wake = p->h;
+                }else if(!closed) {
+                    enqueue(pop_head, pop_tail, w);
+                    return true;
+                }
+            }
+            if(wake) exec.schedule(wake);
+            return false;
+        }
+    private:
+        channel(const channel&);
+        channel& operator= (const channel&);
+    public:
+        class push_awaiter {
+            friend class channel;
+            channel* ch;
+            T value;
+            bool ok;
+            std::coroutine_handle<> h;
+            push_awaiter* next;
+        public:
+            push_awaiter(channel* c, const T& x) : ch(c), value(x), ok(false), next(0) {}
+            bool await_ready() { return false; }
+            bool await_suspend(std::coroutine_handle<> handle) {
+                h = handle;
+                return ch->suspend_push(this);
+            }
+            //通道已关闭时返回false
+            bool await_resume() { return ok; }
+        };
+        class pop_awaiter {
+            friend class channel;
+            channel* ch;
+            std::optional<T> result;
+            std::coroutine_handle<> h;
+            pop_awaiter* next;
+        public:
+            explicit pop_awaiter(channel* c) : ch(c), next(0) {}
+            bool await_ready() { return false; }
+            bool await_suspend(std::coroutine_handle<> handle) {
+                h = handle;
+                return ch->suspend_pop(this);
+            }
+            std::optional<T> await_resume() { return std::move(result); }
+        };
+
+        template <class Executor>
+        explicit channel(Executor& ex, size_type capacity = unbounded)
+            : cap(capacity), closed(false), exec(ex.ref()),
+              push_head(0), push_tail(0), pop_head(0), pop_tail(0) {}
+
+        push_awaiter push(const value_type& x) { return push_awaiter(this, x); }
+        pop_awaiter pop() { return pop_awaiter(this); }
+
+        //关闭后push失败；pop取完剩余数据后得到空值。唤醒所有挂起者
+        void close() {
+            push_awaiter* ps;
+            pop_awaiter* qs;
+            {
+                std::lock_guard<std::mutex> g(m);
+                closed = true;
+                ps = push_head;
+                qs = pop_head;
+                push_head = push_tail = 0;
+                pop_head = pop_tail = 0;
+            }
+            while(ps) {
+                push_awaiter* next = ps->next; //恢复之后awaiter可能已经失效
+                ps->ok = false;
+                exec.schedule(ps->h);
+                ps = next;
+            }
+            while(qs) {
+                pop_awaiter* next = qs->next;
+                exec.schedule(qs->h);
+                qs = next;
+            }
+        }
+        //并发时只是近似值
+        size_type size() {
+            std::lock_guard<std::mutex> g(m);
+            return items.size();
+        }
+        bool empty() { return size() == 0; }
+    };
+}
+#endif //MY_STL_CHANNEL_H
@@ -0,0 +1,375 @@
+#ifndef MY_STL_CONCURRENT_HASH_MAP_H
+#define MY_STL_CONCURRENT_HASH_MAP_H
+//并发散列表：读不加锁，写按桶分条加锁
+//链上的节点发布后不再修改，更新值时换上新节点；摘下的节点经epoch_retire延迟释放，所以读者在epoch_guard内可以放心遍历
+//扩容是渐进的：新表挂在旧表的next上，之后每次写操作顺带迁移一小段桶，迁移完的旧桶换成MOVED标记，读写遇到它就转去新表
+//迁移时复制节点而不是改链，旧链上正在遍历的读者不受影响；Key和T的复制构造不应抛出异常
+//条带数Stripes是2的幂，桶数总是它的倍数，所以同一个键在新旧两张表中的桶属于同一条带
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "mt_alloc.h"
+#include "cons.h"
+#include "epoch.h"
+#include "hash_fun.h"
+#include "functional.h"
+namespace my_stl{
+    template <class Key, class T>
+    struct _chm_node {
+        Key key;
+        T value;
+        size_t hash;
+        std::atomic<_chm_node*> next;
+    };
+    template <class Node>
+    struct _chm_table {
+        size_t mask;                        //桶数 - 1
+        std::atomic<Node*>* buckets;
+        std::atomic<_chm_table*> next;      //扩容时的新表
+        std::atomic<size_t> transfer_index; //下一段待迁移的桶
+        std::atomic<size_t> moved;          //已迁移的桶数
+    };
+    //条带：一把自旋锁和该条带内的元素个数，独占一条cache line
+    struct alignas(64) _chm_stripe {
+        std::atomic<bool> locked;
+        std::atomic<size_t> count;
+
+        _chm_stripe() : locked(false), count(0) {}
+        void lock() {
+            while(locked.exchange(true, std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+        void unlock() { locked.store(false, std::memory_order_release); }
+    };
+
+    template <class Key, class T, class HashFcn = hash<Key>, class EqualKey = equal_to<Key>,
+              class Alloc = mt_alloc, size_t Stripes = 64>
+    class concurrent_hash_map {
+    public:
+        typedef Key key_type;
+        typedef T mapped_type;
+        typedef HashFcn hasher;
+        typedef EqualKey key_equal;
+        typedef size_t size_type;
+    protected:
+        typedef _chm_node<Key, T> node;
+        typedef node* link_type;
+        typedef _chm_table<node> table;
+        typedef my_alloc<node, Alloc> node_allocator;
+        typedef my_alloc<table, Alloc> table_allocator;
+        typedef my_alloc<std::atomic<link_type>, Alloc> bucket_allocator;
+        enum { _transfer_chunk = 16 }; //每次写操作顺带迁移的桶数
+
+        std::atomic<table*> root;
+        _chm_stripe stripes[Stripes];
+        hasher hash;
+        key_equal equals;
+
+        //迁移完的旧桶
+        static link_type moved() { return reinterpret_cast<link_type>(uintptr_t(1)); }
+        size_t hash_of(const key_type& k) const {
+            size_t h = hash(k) * size_t(0x9E3779B97F4A7C15ULL);
+            return h ^ (h >> (sizeof(size_t) * 4));
+        }
+        _chm_stripe& stripe_of(size_t h) { return stripes[h & (Stripes - 1)]; }
+
+        static link_type create_node(const Key& k, const T& v, size_t h) {
+            link_type p = node_allocator::allocate();
+            try {
+                construct(&p->key, k);
+                try {
+                    construct(&p->value, v);
+                }
+                catch(...) {
+                    destroy(&p->key);
+                    throw;
+                }
+            }
+            catch(...) {
+                node_allocator::deallocate(p);
+                throw;
+            }
+            p->hash = h;
+            new(&p->next) std::atomic<link_type>(0);
+            return p;
+        }
+        static void destroy_node(void* q) {
+            link_type p = (link_type) q;
+            destroy(&p->key);
+            destroy(&p->value);
+            node_allocator::deallocate(p);
+        }
+        static table* create_table(size_t n) {
+            table* t = table_allocator::allocate();
+            t->mask = n - 1;
+            t->buckets = bucket_allocator::allocate(n);
+            for(size_t i = 0; i != n; ++i)
+                new(&t->buckets[i]) std::atomic<link_type>(0);
+            new(&t->next) std::atomic<table*>(0);
+            new(&t->transfer_index) std::atomic<size_t>(0);
+            new(&t->moved) std::atomic<size_t>(0);
+            return t;
+        }
+        //只释放桶数组，节点另行处理
+        static void destroy_table(void* q) {
+            table* t = (table*) q;
+            bucket_allocator::deallocate(t->buckets, t->mask + 1);
+            table_allocator::deallocate(t);
+        }
+
+        //把旧表t的第i个桶复制到新表nt，再把旧桶换成MOVED
+        void transfer_bucket(table* t, table* nt, size_t i) {
+            _chm_stripe& s = stripes[i & (Stripes - 1)];
+            s.lock();
+            link_type p = t->buckets[i].load(std::memory_order_relaxed);
+            for(link_type q = p; q; q = q->next.load(std::memory_order_relaxed)) {
+                link_type c = create_node(q->key, q->value, q->hash);
+                std::atomic<link_type>& head = nt->buckets[q->hash & nt->mask];
+                c->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                head.store(c, std::memory_order_release);
+            }
+            t->buckets[i].store(moved(), std::memory_order_release);
+            s.unlock();
+            while(p) {
+                link_type next = p->next.load(std::memory_order_relaxed);
+                epoch_retire(p, &destroy_node);
+                p = next;
+            }
+        }
+        //根表正在扩容时迁移一段桶；迁移完最后一段的线程把新表设为根表
+        void help_transfer() {
+            table* t = root.load(std::memory_order_acquire);
+            table* nt = t->next.load(std::memory_order_acquire);
+            if(nt == 0) return;
+            size_t n = t->mask + 1;
+            size_t b = t->transfer_index.fetch_add(_transfer_chunk, std::memory_order_relaxed);
+            if(b >= n) return;
+            size_t e = b + _transfer_chunk < n ? b + _transfer_chunk : n;
+            for(size_t i = b; i != e; ++i)
+                transfer_bucket(t, nt, i);
+            if(t->moved.fetch_add(e - b, std::memory_order_acq_rel) + (e - b) == n) {
+                root.store(nt, std::memory_order_release);
+                epoch_retire(t, &destroy_table);
+            }
+        }
+        //根表的装载因子估计超过3/4时开始扩容；只看本条带的计数，不必读全部条带
+        void maybe_grow(table* t, size_t stripe_count) {
+            if(stripe_count * Stripes * 4 <= (t->mask + 1) * 3) return;
+            if(t != root.load(std::memory_order_acquire) || t->next.load(std::memory_order_acquire)) return;
+            table* nt = create_table((t->mask + 1) * 2);
+            table* expected = 0;
+            if(!t->next.compare_exchange_strong(expected, nt, std::memory_order_acq_rel))
+                destroy_table(nt);
+        }
+        //加锁并找到h所在的桶；桶在锁内不会被迁移
+        std::atomic<link_type>& lock_bucket(size_t h, table*& t) {
+            help_transfer();
+            stripe_of(h).lock();
+            t = root.load(std::memory_order_acquire);
+            while(t->buckets[h & t->mask].load(std::memory_order_relaxed) == moved())
+                t = t->next.load(std::memory_order_acquire);
+            return t->buckets[h & t->mask];
+        }
+        //在链上找键值为k的节点，prev为指向它的链接
+        link_type find_locked(std::atomic<link_type>& head, const key_type& k, size_t h, std::atomic<link_type>*& prev) {
+            prev = &head;
+            for(link_type p = head.load(std::memory_order_relaxed); p; p = p->next.load(std::memory_order_relaxed)) {
+                if(p->hash == h && equals(p->key, k)) return p;
+                prev = &p->next;
+            }
+            return 0;
+        }
+        //用新节点c替换链上的p
+        static void replace(std::atomic<link_type>* prev, link_type p, link_type c) {
+            c->next.store(p->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            prev->store(c, std::memory_order_release);
+            epoch_retire(p, &destroy_node);
+        }
+        template <class Function>
+        static void visit_bucket(table* t, size_t i, Function& f) {
+            link_type p = t->buckets[i].load(std::memory_order_acquire);
+            if(p == moved()) {
+                //旧桶i的元素分散在新表中下标与i同余的桶里
+                table* nt = t->next.load(std::memory_order_acquire);
+                for(size_t j = i; j <= nt->mask; j += t->mask + 1)
+                    visit_bucket(nt, j, f);
+                return;
+            }
+            for(; p; p = p->next.load(std::memory_order_acquire))
+                f(p->key, p->value);
+        }
+    private:
+        concurrent_hash_map(const concurrent_hash_map&);
+        concurrent_hash_map& operator= (const concurrent_hash_map&);
+    public:
+        //n为预计的元素个数
+        explicit concurrent_hash_map(size_type n = 0, const hasher& hf = hasher(), const key_equal& eql = key_equal())
+            : hash(hf), equals(eql) {
+            size_t b = Stripes;
+            while(b * 3 < n * 4)
+                b *= 2;
+            root.store(create_table(b), std::memory_order_relaxed);
+        }
+        //析构时已无并发访问；未迁移的旧桶和新表中的节点互不重复
+        ~concurrent_hash_map() {
+            table* t = root.load(std::memory_order_relaxed);
+            while(t) {
+                for(size_t i = 0; i <= t->mask; ++i) {
+                    link_type p = t->buckets[i].load(std::memory_order_relaxed);
+                    if(p == moved()) continue;
+                    while(p) {
+                        link_type next = p->next.load(std::memory_order_relaxed);
+                        destroy_node(p);
+                        p = next;
+                    }
+                }
+                table* next = t->next.load(std::memory_order_relaxed);
+                destroy_table(t);
+                t = next;
+            }
+        }
+
+        //并发时只是近似值
+        size_type size() const {
+            size_type n = 0;
+            for(size_t i = 0; i != Stripes; ++i)
+                n += stripes[i].count.load(std::memory_order_relaxed);
+            return n;
+        }
+        bool empty() const { return size() == 0; }
+        size_type bucket_count() const { return root.load(std::memory_order_acquire)->mask + 1; }
+
+        //无锁读：找到时把值复制到out
+        bool find(const key_type& k, T& out) const {
+            size_t h = hash_of(k);
+            epoch_guard g;
+            table* t = root.load(std::memory_order_acquire);
+            for(;;) {
+                link_type p = t->buckets[h & t->mask].load(std::memory_order_acquire);
+                if(p == moved()) {
+                    t = t->next.load(std::memory_order_acquire);
+                    continue;
+                }
+                for(; p; p = p->next.load(std::memory_order_acquire)) {
+                    if(p->hash == h && equals(p->key, k)) {
+                        out = p->value;
+                        return true;
+                    }
+                }
+                return false;
+            }
+        }
+        bool contains(const key_type& k) const {
+            T tmp;
+            return find(k, tmp);
+        }
+        //键值不存在时插入，返回是否插入
+        bool insert(const key_type& k, const T& v) {
+            size_t h = hash_of(k);
+            epoch_guard g;
+            table* t;
+            std::atomic<link_type>& head = lock_bucket(h, t);
+            std::atomic<link_type>* prev;
+            if(find_locked(head, k, h, prev)) {
+                stripe_of(h).unlock();
+                return false;
+            }
+            link_type c;
+            try {
+                c = create_node(k, v, h);
+            }
+            catch(...) {
+                stripe_of(h).unlock();
+                throw;
+            }
+            c->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            head.store(c, std::memory_order_release);
+            size_t n = stripe_of(h).count.fetch_add(1, std::memory_order_relaxed) + 1;
+            stripe_of(h).unlock();
+            maybe_grow(t, n);
+            return true;
+        }
+        //键值存在时替换其值，否则插入；返回是否插入
+        bool insert_or_assign(const key_type& k, const T& v) {
+            size_t h = hash_of(k);
+            epoch_guard g;
+            table* t;
+            std::atomic<link_type>& head = lock_bucket(h, t);
+            std::atomic<link_type>* prev;
+            link_type p = find_locked(head, k, h, prev);
+            link_type c;
+            try {
+                c = create_node(k, v, h);
+            }
+            catch(...) {
+                stripe_of(h).unlock();
+                throw;
+            }
+            if(p) {
+                replace(prev, p, c);
+                stripe_of(h).unlock();
+                return false;
+            }
+            c->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            head.store(c, std::memory_order_release);
+            size_t n = stripe_of(h).count.fetch_add(1, std::memory_order_relaxed) + 1;
+            stripe_of(h).unlock();
+            maybe_grow(t, n);
+            return true;
+        }
+        //在锁内对值的副本调用f(T&)，再换上新节点；同一键的更新互斥。返回键值是否存在
+        template <class Function>
+        bool update(const key_type& k, Function f) {
+            size_t h = hash_of(k);
+            epoch_guard g;
+            table* t;
+            std::atomic<link_type>& head = lock_bucket(h, t);
+            std::atomic<link_type>* prev;
+            link_type p = find_locked(head, k, h, prev);
+            if(p == 0) {
+                stripe_of(h).unlock();
+                return false;
+            }
+            link_type c;
+            try {
+                c = create_node(k, p->value, h);
+                f(c->value);
+            }
+            catch(...) {
+                stripe_of(h).unlock();
+                throw;
+            }
+            replace(prev, p, c);
+            stripe_of(h).unlock();
+            return true;
+        }
+        bool erase(const key_type& k) {
+            size_t h = hash_of(k);
+            epoch_guard g;
+            table* t;
+            std::atomic<link_type>& head = lock_bucket(h, t);
+            std::atomic<link_type>* prev;
+            link_type p = find_locked(head, k, h, prev);
+            if(p == 0) {
+                stripe_of(h).unlock();
+                return false;
+            }
+            prev->store(p->next.load(std::memory_order_relaxed), std::memory_order_release);
+            stripe_of(h).count.fetch_sub(1, std::memory_order_relaxed);
+            stripe_of(h).unlock();
+            epoch_retire(p, &destroy_node);
+            return true;
+        }
+        //对每个元素调用f(const Key&, const T&)；与写操作并发时是弱一致的：遍历期间插入删除的元素可能看到也可能看不到
+        template <class Function>
+        void for_each(Function f) const {
+            epoch_guard g;
+            table* t = root.load(std::memory_order_acquire);
+            for(size_t i = 0; i <= t->mask; ++i)
+                visit_bucket(t, i, f);
+        }
+    };
+}
+#endif //MY_STL_CONCURRENT_HASH_MAP_H
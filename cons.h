@@ -1,7 +1,8 @@
 #ifndef MY_STL_CONS_H
 #define MY_STL_CONS_H
-#include <new.h>
+#include <new>
 #include "type_traits.h"
+#include "iterator.h"
 namespace my_stl {
     template<class T1, class T2>
     //placement new;调用T1::T1(value)
@@ -16,11 +17,16 @@ namespace my_stl {
     }
 
     template<class ForwardIterator>
-    //第二版，接受前后两个迭代器，试图找出元素类型，进而利用_type_traits<>求取最适当方式
-    inline void destroy(ForwardIterator begin, ForwardIterator end) {
-        _destroy(begin, end, value_type(begin));
+    //如果有non_trivial destructor
+    inline void _destroy_aux(ForwardIterator begin, ForwardIterator end, _false_type) {
+        for (; begin < end; ++begin)
+            destroy(&*begin);
     }
 
+    template<class ForwardIterator>
+    //如果有trivial destructor,什么也不做
+    inline void _destroy_aux(ForwardIterator begin, ForwardIterator end, _true_type) {}
+
     template<class ForwardIterator, class T>
     //判断是否有trivial destructor
     inline void _destroy(ForwardIterator begin, ForwardIterator end, T *) {
@@ -29,16 +35,12 @@ namespace my_stl {
     }
 
     template<class ForwardIterator>
-    //如果有non_trivial destructor
-    inline void _destroy_aux(ForwardIterator begin, ForwardIterator end, _false_type) {
-        for (; begin < end; ++begin)
-            destroy(&*begin);
+    //第二版，接受前后两个迭代器，试图找出元素类型，进而利用_type_traits<>求取最适当方式
+    //_destroy须在此之前声明，否则元素类型不在my_stl中时找不到它
+    inline void destroy(ForwardIterator begin, ForwardIterator end) {
+        _destroy(begin, end, value_type(begin));
     }
 
-    template<class ForwardIterator>
-    //如果有trivial destructor,什么也不做
-    inline void _destroy_aux(ForwardIterator begin, ForwardIterator end, _true_type) {}
-
 // 第二版destory 泛型特化
     inline void destroy(char *, char *) {}
 
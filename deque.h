@@ -4,6 +4,7 @@
 #include "cons.h"
 #include "alloc.h"
 #include "unin.h"
+#include "algorithm.h"
 //deque由分段连续的空间组成，需要分段控制维护其逻辑连续
 namespace my_stl{
     //n不为0则返回n，表示buffer_size由用户定义
@@ -40,7 +41,7 @@ namespace my_stl{
         }
         //重载运算子
         reference operator* () const { return *cur; }
-        pointer operator-> () const { return &(operator*())}
+        pointer operator-> () const { return &(operator*()); }
         difference_type operator- (const self& x) const {
             return difference_type(buffer_size()) * (node - x.node - 1) + (cur - first) + (x.last - x.cur);
         }
@@ -99,7 +100,7 @@ namespace my_stl{
         bool operator== (const self& x) const {
             return cur == x.cur;
         }
-        bool operator!= (const self& x) cons {
+        bool operator!= (const self& x) const {
             return !(*this == x);
         }
         bool operator< (const self& x) const {
@@ -130,6 +131,10 @@ namespace my_stl{
         static size_t buffer_size() {
             return _deque_buf_size(BufSiz, sizeof(T));
         }
+        //map最少管理的节点数
+        static size_type initial_map_size() {
+            return 8;
+        }
         T* allocate_node() {
             return data_allocator::allocate(buffer_size());
         }
@@ -179,9 +184,42 @@ namespace my_stl{
         }
         void fill_initialize(size_type n, const value_type& value);
         void create_map_and_nodes(size_type num_elements);
+        deque() : start(), finish(), map(0), map_size(0) {
+            create_map_and_nodes(0);
+        }
         deque(int n, const value_type& value) : start(), finish(), map(0), map_size(0) {
             fill_initialize(n, value);
         }
+        //深复制：按x的元素个数配置map与缓冲区，再逐段构造
+        deque(const deque& x) : start(), finish(), map(0), map_size(0) {
+            create_map_and_nodes(x.size());
+            uninitialized_copy(x.start, x.finish, start);
+        }
+        deque& operator= (const deque& x) {
+            if(this != &x) {
+                deque tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        void swap(deque& x) {
+            iterator tmp_start = start, tmp_finish = finish;
+            start = x.start;
+            finish = x.finish;
+            x.start = tmp_start;
+            x.finish = tmp_finish;
+            map_pointer tmp_map = map;
+            map = x.map;
+            x.map = tmp_map;
+            size_type tmp_size = map_size;
+            map_size = x.map_size;
+            x.map_size = tmp_size;
+        }
+        ~deque() {
+            clear();  //clear()保留start所在的缓冲区
+            deallocate_node(*start.node);
+            map_allocator::deallocate(map, map_size);
+        }
         void push_back(const value_type& t) {
             if(finish.cur != finish.last - 1) {
                 construct(finish.cur, t);
@@ -265,7 +303,7 @@ namespace my_stl{
                 return start + elems_before;
             }
         }
-        iterator insert(iterator position, const vaule_type& x) {
+        iterator insert(iterator position, const value_type& x) {
             if(position.cur == start.cur) {
                 push_front(x);
                 return start;
@@ -302,7 +340,7 @@ namespace my_stl{
     void deque<T, Alloc, BufSize>::fill_initialize(size_type n, const value_type& value) {
         create_map_and_nodes(n);
         map_pointer cur;
-        for(cur = start.node; *cur < finish.node; ++cur)
+        for(cur = start.node; cur < finish.node; ++cur)
             uninitialized_fill(*cur, *cur + buffer_size(), value);
         uninitialized_fill(finish.first, finish.cur, value);
     }
@@ -362,7 +400,7 @@ namespace my_stl{
         start.cur = start.first;
     }
     template <class T, class Alloc, size_t BufSize>
-    iterator deque<T, Alloc, BufSize>::insert_aux(iterator pos, const int &x) {
+    typename deque<T, Alloc, BufSize>::iterator deque<T, Alloc, BufSize>::insert_aux(iterator pos, const value_type &x) {
         difference_type index = pos - start;
         value_type x_copy = x;
         if(index < (size() / 2)) {
@@ -0,0 +1,154 @@
+#ifndef MY_STL_EPOCH_H
+#define MY_STL_EPOCH_H
+//基于纪元(epoch)的内存回收，供无锁容器使用
+//读者在epoch_guard的生命期内可以安全地解引用共享节点
+//被摘下的节点用epoch_retire()登记，等所有线程都离开了登记时的纪元(全局纪元前进两次)后才真正释放
+//因为节点在释放前不会被重用，也就不会出现ABA问题
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "alloc.h"
+namespace my_stl{
+    struct _epoch_bag {
+        enum { _capacity = 62 };
+        struct entry {
+            void* p;
+            void (*deleter)(void*);
+        };
+        entry items[_capacity];
+        size_t count;
+        _epoch_bag* next;
+    };
+    //每个线程一条记录，线程退出后记录可被新线程复用
+    struct _epoch_record {
+        std::atomic<uint64_t> epoch;   //进入临界区时看到的全局纪元，0表示不在临界区
+        std::atomic<bool> in_use;
+        unsigned nest;                 //epoch_guard可以嵌套
+        unsigned retire_count;
+        _epoch_bag* limbo[3];          //按纪元模3分组的待释放对象
+        uint64_t limbo_epoch[3];
+        _epoch_record* next;
+    };
+
+    template <int inst>
+    class _epoch_domain_template {
+    private:
+        enum { _advance_interval = 64 }; //每登记这么多个对象尝试推进一次纪元
+        typedef my_alloc<_epoch_bag, malloc_alloc> bag_allocator;
+        typedef my_alloc<_epoch_record, malloc_alloc> record_allocator;
+
+        static std::atomic<uint64_t> global_epoch;
+        static std::atomic<_epoch_record*> records;
+
+        static _epoch_record* acquire_record() {
+            for(_epoch_record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+                bool expected = false;
+                if(!r->in_use.load(std::memory_order_relaxed) &&
+                   r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    return r;
+            }
+            _epoch_record* r = record_allocator::allocate();
+            new(&r->epoch) std::atomic<uint64_t>(0);
+            new(&r->in_use) std::atomic<bool>(true);
+            r->nest = 0;
+            r->retire_count = 0;
+            for(int i = 0; i < 3; ++i) {
+                r->limbo[i] = 0;
+                r->limbo_epoch[i] = 0;
+            }
+            _epoch_record* head = records.load(std::memory_order_relaxed);
+            do {
+                r->next = head;
+            } while(!records.compare_exchange_weak(head, r, std::memory_order_release, std::memory_order_relaxed));
+            return r;
+        }
+        //thread_local持有者，线程退出时归还记录(未释放的对象留给下一个使用者)
+        struct record_holder {
+            _epoch_record* r;
+            record_holder() : r(acquire_record()) {}
+            ~record_holder() { r->in_use.store(false, std::memory_order_release); }
+        };
+        static void free_bag(_epoch_bag* b) {
+            while(b) {
+                for(size_t i = 0; i != b->count; ++i)
+                    b->items[i].deleter(b->items[i].p);
+                _epoch_bag* next = b->next;
+                bag_allocator::deallocate(b);
+                b = next;
+            }
+        }
+        //所有处于临界区的线程都已看到当前纪元时，全局纪元加1
+        static void try_advance() {
+            //与enter()中的seq_cst fence配对：摘链发生在扫描之前，扫描时没看到某线程的纪元，则该线程一定读不到已摘下的指针
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            uint64_t e = global_epoch.load(std::memory_order_acquire);
+            for(_epoch_record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+                uint64_t re = r->epoch.load(std::memory_order_acquire);
+                if(re != 0 && re != e) return;
+            }
+            global_epoch.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel);
+        }
+    public:
+        static _epoch_record* local() {
+            static thread_local record_holder h;
+            return h.r;
+        }
+        static void enter() {
+            _epoch_record* r = local();
+            if(r->nest++ == 0) {
+                r->epoch.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                //公布纪元之后才能读共享指针
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+        static void leave() {
+            _epoch_record* r = local();
+            if(--r->nest == 0)
+                r->epoch.store(0, std::memory_order_release);
+        }
+        static void retire(void* p, void (*deleter)(void*)) {
+            _epoch_record* r = local();
+            uint64_t e = global_epoch.load(std::memory_order_acquire);
+            int slot = int(e % 3);
+            if(r->limbo_epoch[slot] != e) {
+                //该组是e-3或更早登记的，所有线程都已离开那些纪元
+                free_bag(r->limbo[slot]);
+                r->limbo[slot] = 0;
+                r->limbo_epoch[slot] = e;
+            }
+            _epoch_bag* b = r->limbo[slot];
+            if(b == 0 || b->count == _epoch_bag::_capacity) {
+                _epoch_bag* nb = bag_allocator::allocate();
+                nb->count = 0;
+                nb->next = b;
+                r->limbo[slot] = b = nb;
+            }
+            b->items[b->count].p = p;
+            b->items[b->count].deleter = deleter;
+            ++b->count;
+            if(++r->retire_count % _advance_interval == 0)
+                try_advance();
+        }
+    };
+    template <int inst>
+    std::atomic<uint64_t> _epoch_domain_template<inst>::global_epoch(1);
+    template <int inst>
+    std::atomic<_epoch_record*> _epoch_domain_template<inst>::records(0);
+    typedef _epoch_domain_template<0> epoch_domain;
+
+    //RAII：构造时进入临界区，析构时离开
+    class epoch_guard {
+    public:
+        epoch_guard() { epoch_domain::enter(); }
+        ~epoch_guard() { epoch_domain::leave(); }
+    private:
+        epoch_guard(const epoch_guard&);
+        epoch_guard& operator= (const epoch_guard&);
+    };
+
+    template <class T>
+    inline void epoch_retire(T* p, void (*deleter)(void*)) {
+        epoch_domain::retire(p, deleter);
+    }
+}
+#endif //MY_STL_EPOCH_H
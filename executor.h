@@ -0,0 +1,136 @@
+#ifndef MY_STL_EXECUTOR_H
+#define MY_STL_EXECUTOR_H
+//C++20协程的执行器
+//local_executor：单线程，就绪的协程排在queue里由run()依次恢复
+//pool_executor：多线程，把协程的恢复提交给work_stealing_pool
+//协程挂起时不占用线程，所以流水线的每一级不需要独占一个线程
+#include <coroutine>
+#include <exception>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include "queue.h"
+#include "thread_pool.h"
+namespace my_stl{
+    //执行器的类型擦除引用，只需要能调度一个协程句柄
+    struct _executor_ref {
+        void* self;
+        void (*schedule_fn)(void*, std::coroutine_handle<>);
+        void schedule(std::coroutine_handle<> h) const {
+            schedule_fn(self, h);
+        }
+    };
+
+    //即发即弃的协程，由执行器的spawn()启动，执行完自动销毁
+    //没有人等待它的结果，异常无处可交，与std::thread一样逸出的异常调用std::terminate()
+    class detached_task {
+    public:
+        struct promise_type {
+            std::atomic<size_t>* live; //不为0时，结束时计数减1
+            promise_type() : live(0) {}
+            ~promise_type() {
+                if(live) live->fetch_sub(1, std::memory_order_release);
+            }
+            detached_task get_return_object() {
+                return detached_task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return std::suspend_always(); }
+            std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+            void return_void() {}
+            //重新抛出会从恢复它的线程(通常是线程池的工作线程)逸出，协程帧也不会被销毁
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+        typedef std::coroutine_handle<promise_type> handle_type;
+    protected:
+        handle_type h;
+    public:
+        explicit detached_task(handle_type x) : h(x) {}
+        detached_task(detached_task&& x) : h(x.h) { x.h = handle_type(); }
+        ~detached_task() {
+            if(h) h.destroy(); //从未启动过
+        }
+        //交出句柄，由执行器负责启动
+        handle_type release() {
+            handle_type r = h;
+            h = handle_type();
+            return r;
+        }
+    private:
+        detached_task(const detached_task&);
+        detached_task& operator= (const detached_task&);
+    };
+
+    //单线程执行器，不可跨线程使用
+    class local_executor {
+    protected:
+        //包一层，避免deque内部对destroy等的调用经ADL找到std里的同名函数
+        struct ready_entry {
+            std::coroutine_handle<> h;
+        };
+        queue<ready_entry> ready;
+
+        static void schedule_impl(void* self, std::coroutine_handle<> h) {
+            static_cast<local_executor*>(self)->schedule(h);
+        }
+    public:
+        _executor_ref ref() {
+            _executor_ref r = { this, &schedule_impl };
+            return r;
+        }
+        void schedule(std::coroutine_handle<> h) {
+            ready_entry e = { h };
+            ready.push(e);
+        }
+        void spawn(detached_task t) { schedule(t.release()); }
+        //恢复就绪的协程，直到没有可运行的为止
+        void run() {
+            while(!ready.empty()) {
+                std::coroutine_handle<> h = ready.front().h;
+                ready.pop();
+                h.resume();
+            }
+        }
+    };
+
+    //多线程执行器
+    template <class Alloc = malloc_alloc>
+    class pool_executor {
+    public:
+        typedef work_stealing_pool<Alloc> pool_type;
+    protected:
+        pool_type& pool;
+        std::atomic<size_t> live; //尚未结束的spawn出来的协程数
+
+        struct resume_fn {
+            std::coroutine_handle<> h;
+            void operator() () { h.resume(); }
+        };
+        static void schedule_impl(void* self, std::coroutine_handle<> h) {
+            static_cast<pool_executor*>(self)->schedule(h);
+        }
+    public:
+        explicit pool_executor(pool_type& p) : pool(p), live(0) {}
+        _executor_ref ref() {
+            _executor_ref r = { this, &schedule_impl };
+            return r;
+        }
+        void schedule(std::coroutine_handle<> h) {
+            resume_fn f = { h };
+            pool.submit(f);
+        }
+        void spawn(detached_task t) {
+            detached_task::handle_type h = t.release();
+            live.fetch_add(1, std::memory_order_relaxed);
+            h.promise().live = &live;
+            schedule(h);
+        }
+        //等所有spawn出来的协程结束，等待期间帮忙执行任务
+        void join() {
+            while(live.load(std::memory_order_acquire) != 0) {
+                if(!pool.run_one())
+                    std::this_thread::yield();
+            }
+        }
+    };
+}
+#endif //MY_STL_EXECUTOR_H
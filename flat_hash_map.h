@@ -0,0 +1,72 @@
+#ifndef MY_STL_FLAT_HASH_MAP_H
+#define MY_STL_FLAT_HASH_MAP_H
+//flat_hash_map：以flat_hash_table为底层，元素是pair<const Key, T>，以first为键值，键值不允许重复，元素无序
+#include "flat_hash_table.h"
+#include "hash_fun.h"
+#include "functional.h"
+#include "pair.h"
+namespace my_stl{
+    template <class Key, class T, class HashFcn = hash<Key>, class EqualKey = equal_to<Key>, class Alloc = alloc>
+    class flat_hash_map {
+    protected:
+        typedef flat_hash_table<pair<const Key, T>, Key, HashFcn, select1st<pair<const Key, T> >, EqualKey, Alloc> rep_type;
+        rep_type rep;
+    public:
+        typedef typename rep_type::key_type key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef typename rep_type::value_type value_type;
+        typedef typename rep_type::hasher hasher;
+        typedef typename rep_type::key_equal key_equal;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+        typedef typename rep_type::pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        //可以通过迭代器改变second，first是const的
+        typedef typename rep_type::iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+
+        flat_hash_map() : rep(hasher(), key_equal()) {}
+        explicit flat_hash_map(size_type n) : rep(hasher(), key_equal()) { rep.reserve(n); }
+        flat_hash_map(size_type n, const hasher& hf) : rep(hf, key_equal()) { rep.reserve(n); }
+        flat_hash_map(size_type n, const hasher& hf, const key_equal& eql) : rep(hf, eql) { rep.reserve(n); }
+        template <class InputIterator>
+        flat_hash_map(InputIterator first, InputIterator last) : rep(hasher(), key_equal()) { rep.insert_unique(first, last); }
+
+        hasher hash_funct() const { return rep.hash_funct(); }
+        key_equal key_eq() const { return rep.key_eq(); }
+        iterator begin() { return rep.begin(); }
+        iterator end() { return rep.end(); }
+        const_iterator begin() const { return rep.begin(); }
+        const_iterator end() const { return rep.end(); }
+        bool empty() const { return rep.empty(); }
+        size_type size() const { return rep.size(); }
+        size_type max_size() const { return rep.max_size(); }
+        size_type bucket_count() const { return rep.bucket_count(); }
+        float load_factor() const { return rep.load_factor(); }
+        float max_load_factor() const { return rep.max_load_factor(); }
+        void max_load_factor(float f) { rep.max_load_factor(f); }
+        void reserve(size_type n) { rep.reserve(n); }
+        void swap(flat_hash_map& x) { rep.swap(x.rep); }
+
+        pair<iterator, bool> insert(const value_type& obj) { return rep.insert_unique(obj); }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) { rep.insert_unique(first, last); }
+        T& operator[] (const key_type& k) { return rep.find_or_insert(value_type(k, T())).second; }
+        void erase(const_iterator position) { rep.erase(position); }
+        size_type erase(const key_type& k) { return rep.erase(k); }
+        void erase(const_iterator first, const_iterator last) { rep.erase(first, last); }
+        void clear() { rep.clear(); }
+
+        iterator find(const key_type& k) { return rep.find(k); }
+        const_iterator find(const key_type& k) const { return rep.find(k); }
+        size_type count(const key_type& k) const { return rep.count(k); }
+        pair<iterator, iterator> equal_range(const key_type& k) { return rep.equal_range(k); }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const { return rep.equal_range(k); }
+
+        friend bool operator== (const flat_hash_map& x, const flat_hash_map& y) { return x.rep == y.rep; }
+    };
+}
+#endif //MY_STL_FLAT_HASH_MAP_H
@@ -0,0 +1,67 @@
+#ifndef MY_STL_FLAT_HASH_SET_H
+#define MY_STL_FLAT_HASH_SET_H
+//flat_hash_set：以flat_hash_table为底层，元素的键值就是元素本身，键值不允许重复，元素无序
+#include "flat_hash_table.h"
+#include "hash_fun.h"
+#include "functional.h"
+namespace my_stl{
+    template <class Value, class HashFcn = hash<Value>, class EqualKey = equal_to<Value>, class Alloc = alloc>
+    class flat_hash_set {
+    protected:
+        typedef flat_hash_table<Value, Value, HashFcn, identity<Value>, EqualKey, Alloc> rep_type;
+        rep_type rep;
+    public:
+        typedef typename rep_type::key_type key_type;
+        typedef typename rep_type::value_type value_type;
+        typedef typename rep_type::hasher hasher;
+        typedef typename rep_type::key_equal key_equal;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+        typedef typename rep_type::const_pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::const_reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        //不允许通过迭代器改变元素值，iterator也是const_iterator
+        typedef typename rep_type::const_iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+
+        flat_hash_set() : rep(hasher(), key_equal()) {}
+        explicit flat_hash_set(size_type n) : rep(hasher(), key_equal()) { rep.reserve(n); }
+        flat_hash_set(size_type n, const hasher& hf) : rep(hf, key_equal()) { rep.reserve(n); }
+        flat_hash_set(size_type n, const hasher& hf, const key_equal& eql) : rep(hf, eql) { rep.reserve(n); }
+        template <class InputIterator>
+        flat_hash_set(InputIterator first, InputIterator last) : rep(hasher(), key_equal()) { rep.insert_unique(first, last); }
+
+        hasher hash_funct() const { return rep.hash_funct(); }
+        key_equal key_eq() const { return rep.key_eq(); }
+        iterator begin() const { return rep.begin(); }
+        iterator end() const { return rep.end(); }
+        bool empty() const { return rep.empty(); }
+        size_type size() const { return rep.size(); }
+        size_type max_size() const { return rep.max_size(); }
+        size_type bucket_count() const { return rep.bucket_count(); }
+        float load_factor() const { return rep.load_factor(); }
+        float max_load_factor() const { return rep.max_load_factor(); }
+        void max_load_factor(float f) { rep.max_load_factor(f); }
+        void reserve(size_type n) { rep.reserve(n); }
+        void swap(flat_hash_set& x) { rep.swap(x.rep); }
+
+        pair<iterator, bool> insert(const value_type& obj) {
+            pair<typename rep_type::iterator, bool> p = rep.insert_unique(obj);
+            return pair<iterator, bool>(p.first, p.second);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) { rep.insert_unique(first, last); }
+        void erase(iterator position) { rep.erase(position); }
+        size_type erase(const key_type& k) { return rep.erase(k); }
+        void erase(iterator first, iterator last) { rep.erase(first, last); }
+        void clear() { rep.clear(); }
+
+        iterator find(const key_type& k) const { return rep.find(k); }
+        size_type count(const key_type& k) const { return rep.count(k); }
+        pair<iterator, iterator> equal_range(const key_type& k) const { return rep.equal_range(k); }
+
+        friend bool operator== (const flat_hash_set& x, const flat_hash_set& y) { return x.rep == y.rep; }
+    };
+}
+#endif //MY_STL_FLAT_HASH_SET_H
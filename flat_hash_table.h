@@ -0,0 +1,441 @@
+#ifndef MY_STL_FLAT_HASH_TABLE_H
+#define MY_STL_FLAT_HASH_TABLE_H
+//开放定址散列表(Swiss table)：元素直接存放在槽数组中，每个槽另有1字节的控制字
+//控制字为空、已删除、哨兵，或者该元素散列值的低7位(H2)；其余位(H1)决定探测的起点
+//查找时一次比较一组(SSE2下16个，否则8个)控制字，只有H2相同的槽才去比较键值
+//槽数为2^k - 1，控制字数组末尾复制了前width - 1个控制字，从任意位置读一整组都不必回绕
+//flat_hash_set与flat_hash_map的底层；插入可能搬动所有元素，使迭代器失效
+#include <cstddef>
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "iterator.h"
+#include "alloc.h"
+#include "cons.h"
+#include "pair.h"
+namespace my_stl{
+    typedef signed char _swiss_ctrl;
+    enum {
+        _swiss_empty = -128,
+        _swiss_deleted = -2,
+        _swiss_sentinel = -1
+    };
+
+#if defined(__SSE2__)
+    //一组16个控制字，匹配结果为16位掩码，第i位对应第i个槽
+    struct _swiss_group {
+        enum { width = 16, shift = 0 };
+        __m128i ctrl;
+
+        explicit _swiss_group(const _swiss_ctrl* p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+        uint64_t match(_swiss_ctrl h2) const {
+            return uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+        }
+        uint64_t match_empty() const { return match(_swiss_empty); }
+        //空或已删除：小于哨兵的控制字
+        uint64_t match_empty_or_deleted() const {
+            return uint64_t(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(_swiss_sentinel), ctrl)));
+        }
+    };
+#else
+    //可移植的实现：一组8个控制字装入一个uint64_t，第i个槽对应掩码的第8i + 7位
+    struct _swiss_group {
+        enum { width = 8, shift = 3 };
+        uint64_t ctrl;
+
+        explicit _swiss_group(const _swiss_ctrl* p) {
+            ctrl = 0;
+            for(int i = 0; i != width; ++i)
+                ctrl |= uint64_t((unsigned char) p[i]) << (8 * i);
+        }
+        static uint64_t lsbs() { return 0x0101010101010101ULL; }
+        static uint64_t msbs() { return 0x8080808080808080ULL; }
+        //可能有假阳性(只出现在真正匹配的槽之后)，调用者总会再比较键值
+        uint64_t match(_swiss_ctrl h2) const {
+            uint64_t x = ctrl ^ (lsbs() * (unsigned char) h2);
+            return (x - lsbs()) & ~x & msbs();
+        }
+        //空(0x80)是唯一最高位为1而第1位为0的控制字
+        uint64_t match_empty() const { return ctrl & ~(ctrl << 6) & msbs(); }
+        //空和已删除的最高位为1、第0位为0，哨兵(0xFF)的第0位为1
+        uint64_t match_empty_or_deleted() const { return ctrl & ~(ctrl << 7) & msbs(); }
+    };
+#endif
+    //掩码m(不为0)中最低的匹配位对应的槽在组内的下标
+    inline size_t _swiss_lowest(uint64_t m) { return size_t(__builtin_ctzll(m)) >> _swiss_group::shift; }
+    //组的末尾连续不匹配的槽数，m不为0
+    inline size_t _swiss_leading(uint64_t m) {
+        return size_t(__builtin_clzll(m) - (64 - (_swiss_group::width << _swiss_group::shift))) >> _swiss_group::shift;
+    }
+    //控制字数组的初始状态：空表的begin()直接落在哨兵上
+    inline _swiss_ctrl* _swiss_empty_ctrl() {
+        static _swiss_ctrl ctrl[_swiss_group::width] = { _swiss_sentinel };
+        return ctrl;
+    }
+
+    //迭代器：控制字指针 + 槽指针，跳过空和已删除的槽；哨兵为end()
+    template <class Value, class Ref, class Ptr>
+    struct _flat_hash_iterator {
+        typedef _flat_hash_iterator<Value, Value&, Value*> iterator;
+        typedef _flat_hash_iterator<Value, Ref, Ptr> self;
+        typedef forward_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        const _swiss_ctrl* ctrl;
+        Value* slot;
+
+        _flat_hash_iterator() {}
+        _flat_hash_iterator(const _swiss_ctrl* c, Value* s) : ctrl(c), slot(s) {}
+        _flat_hash_iterator(const iterator& x) : ctrl(x.ctrl), slot(x.slot) {}
+
+        bool operator== (const self& x) const { return ctrl == x.ctrl; }
+        bool operator!= (const self& x) const { return ctrl != x.ctrl; }
+        reference operator*() const { return *slot; }
+        pointer operator->() const { return &(operator*()); }
+        //跳到下一个有元素的槽或哨兵
+        void skip_empty_or_deleted() {
+            while(*ctrl < _swiss_sentinel) {
+                ++ctrl;
+                ++slot;
+            }
+        }
+        self& operator++() {
+            ++ctrl;
+            ++slot;
+            skip_empty_or_deleted();
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+    };
+
+    //键值唯一的开放定址散列表，模板参数的次序沿用SGI的hashtable
+    template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class Alloc = alloc>
+    class flat_hash_table {
+    public:
+        typedef Key key_type;
+        typedef Value value_type;
+        typedef HashFcn hasher;
+        typedef EqualKey key_equal;
+        typedef value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _flat_hash_iterator<Value, Value&, Value*> iterator;
+        typedef _flat_hash_iterator<Value, const Value&, const Value*> const_iterator;
+    protected:
+        typedef my_alloc<_swiss_ctrl, Alloc> ctrl_allocator;
+        typedef my_alloc<Value, Alloc> slot_allocator;
+        enum { _cloned = _swiss_group::width - 1 };
+        enum { _min_capacity = 15 };
+
+        _swiss_ctrl* ctrl;
+        Value* slots;
+        size_type cap;          //槽数，0或2^k - 1
+        size_type num_elements;
+        size_type growth_left;  //不扩容还能占用的空槽数；占用已删除的槽不消耗它
+        float max_load;
+        hasher hash;
+        key_equal equals;
+        ExtractKey get_key;
+
+        //把散列值搅匀，SGI的hash<int>就是数值本身，直接取低位分组效果很差
+        static size_t mix(size_t h) {
+            h *= size_t(0x9E3779B97F4A7C15ULL);
+            return h ^ (h >> (sizeof(size_t) * 4));
+        }
+        static _swiss_ctrl h2(size_t h) { return _swiss_ctrl(h & 0x7F); }
+        size_type probe_start(size_t h) const { return (h >> 7) & cap; }
+        //容量为c时最多容纳的元素个数，至少留一个空槽让探测能够停下
+        size_type growth_of(size_type c) const {
+            size_type g = size_type(c * max_load);
+            return g < c ? g : c - 1;
+        }
+        //同时写入复制的控制字
+        void set_ctrl(size_type i, _swiss_ctrl h) {
+            ctrl[i] = h;
+            ctrl[((i - _cloned) & cap) + (_cloned & cap)] = h;
+        }
+        //探测序列上第一个空或已删除的槽；组的步长依次为width、2width...，2^k个组的起点都会被走到
+        size_type find_first_non_full(size_t h) const {
+            size_type pos = probe_start(h);
+            size_type step = 0;
+            for(;;) {
+                uint64_t m = _swiss_group(ctrl + pos).match_empty_or_deleted();
+                if(m) return (pos + _swiss_lowest(m)) & cap;
+                step += _swiss_group::width;
+                pos = (pos + step) & cap;
+            }
+        }
+        size_type find_index(const key_type& k, size_t h) const {
+            if(cap == 0) return cap;
+            _swiss_ctrl tag = h2(h);
+            size_type pos = probe_start(h);
+            size_type step = 0;
+            for(;;) {
+                _swiss_group g(ctrl + pos);
+                for(uint64_t m = g.match(tag); m; m &= m - 1) {
+                    size_type i = (pos + _swiss_lowest(m)) & cap;
+                    if(equals(get_key(slots[i]), k)) return i;
+                }
+                //组内有空槽说明k从未被挤到更后面的组
+                if(g.match_empty()) return cap;
+                step += _swiss_group::width;
+                pos = (pos + step) & cap;
+            }
+        }
+        void initialize(size_type c) {
+            cap = c;
+            ctrl = ctrl_allocator::allocate(c + _swiss_group::width);
+            slots = slot_allocator::allocate(c);
+            for(size_type i = 0; i != c + _swiss_group::width; ++i)
+                ctrl[i] = _swiss_empty;
+            ctrl[c] = _swiss_sentinel;
+            growth_left = growth_of(c);
+        }
+        void empty_initialize() {
+            ctrl = _swiss_empty_ctrl();
+            slots = 0;
+            cap = 0;
+            num_elements = 0;
+            growth_left = 0;
+        }
+        void deallocate() {
+            if(cap) {
+                ctrl_allocator::deallocate(ctrl, cap + _swiss_group::width);
+                slot_allocator::deallocate(slots, cap);
+            }
+        }
+        void destroy_slots() {
+            for(size_type i = 0; i != cap; ++i)
+                if(ctrl[i] >= 0) destroy(&slots[i]);
+        }
+        //能容纳n个元素的最小容量
+        size_type capacity_for(size_type n) const {
+            size_type c = _min_capacity;
+            while(growth_of(c) < n)
+                c = c * 2 + 1;
+            return c;
+        }
+        //换到容量为c的新表，顺便清除所有已删除标记
+        void resize(size_type c) {
+            _swiss_ctrl* old_ctrl = ctrl;
+            Value* old_slots = slots;
+            size_type old_cap = cap;
+            initialize(c);
+            try {
+                for(size_type i = 0; i != old_cap; ++i) {
+                    if(old_ctrl[i] >= 0) {
+                        size_t h = mix(hash(get_key(old_slots[i])));
+                        size_type j = find_first_non_full(h);
+                        construct(&slots[j], old_slots[i]);
+                        set_ctrl(j, h2(h));
+                    }
+                }
+            }
+            catch(...) {
+                destroy_slots();
+                deallocate();
+                ctrl = old_ctrl;
+                slots = old_slots;
+                cap = old_cap;
+                growth_left = 0;
+                throw;
+            }
+            growth_left -= num_elements;
+            for(size_type i = 0; i != old_cap; ++i)
+                if(old_ctrl[i] >= 0) destroy(&old_slots[i]);
+            if(old_cap) {
+                ctrl_allocator::deallocate(old_ctrl, old_cap + _swiss_group::width);
+                slot_allocator::deallocate(old_slots, old_cap);
+            }
+        }
+        //没有余量时：已删除的槽占了一大半余量就原地重建，否则容量翻倍
+        void rehash_and_grow() {
+            if(cap == 0) resize(_min_capacity);
+            else if(num_elements * 2 <= growth_of(cap)) resize(cap);
+            else resize(cap * 2 + 1);
+        }
+        //为散列值为h、尚不存在的键找一个槽，并标记为已占用
+        size_type prepare_insert(size_t h) {
+            size_type i = cap ? find_first_non_full(h) : 0;
+            if(growth_left == 0 && (cap == 0 || ctrl[i] != _swiss_deleted)) {
+                rehash_and_grow();
+                i = find_first_non_full(h);
+            }
+            if(ctrl[i] == _swiss_empty) --growth_left;
+            set_ctrl(i, h2(h));
+            ++num_elements;
+            return i;
+        }
+        //构造失败时撤销prepare_insert
+        void cancel_insert(size_type i) {
+            --num_elements;
+            set_ctrl(i, _swiss_deleted);
+        }
+    public:
+        flat_hash_table(const HashFcn& hf = HashFcn(), const EqualKey& eql = EqualKey())
+            : max_load(0.875f), hash(hf), equals(eql), get_key(ExtractKey()) { empty_initialize(); }
+        flat_hash_table(const flat_hash_table& x)
+            : max_load(x.max_load), hash(x.hash), equals(x.equals), get_key(x.get_key) {
+            empty_initialize();
+            if(x.num_elements) {
+                resize(capacity_for(x.num_elements));
+                for(const_iterator it = x.begin(); it != x.end(); ++it)
+                    insert_unique(*it);
+            }
+        }
+        flat_hash_table& operator= (const flat_hash_table& x) {
+            if(this != &x) {
+                flat_hash_table tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        ~flat_hash_table() {
+            destroy_slots();
+            deallocate();
+        }
+
+        hasher hash_funct() const { return hash; }
+        key_equal key_eq() const { return equals; }
+        iterator begin() {
+            iterator it(ctrl, slots);
+            it.skip_empty_or_deleted();
+            return it;
+        }
+        iterator end() { return iterator(ctrl + cap, slots + cap); }
+        const_iterator begin() const {
+            const_iterator it(ctrl, slots);
+            it.skip_empty_or_deleted();
+            return it;
+        }
+        const_iterator end() const { return const_iterator(ctrl + cap, slots + cap); }
+        bool empty() const { return num_elements == 0; }
+        size_type size() const { return num_elements; }
+        size_type max_size() const { return size_type(-1) / sizeof(Value); }
+        size_type bucket_count() const { return cap; }
+        float load_factor() const { return cap ? float(num_elements) / cap : 0.0f; }
+        float max_load_factor() const { return max_load; }
+        //最大装载因子取(0, 1)，按新的装载因子重建
+        void max_load_factor(float f) {
+            max_load = f;
+            if(cap) resize(capacity_for(num_elements));
+        }
+        //保证容纳n个元素前不再扩容
+        void reserve(size_type n) {
+            if(n > num_elements + growth_left)
+                resize(capacity_for(n));
+        }
+        void swap(flat_hash_table& x) {
+            _swiss_ctrl* c = ctrl; ctrl = x.ctrl; x.ctrl = c;
+            Value* s = slots; slots = x.slots; x.slots = s;
+            size_type n = cap; cap = x.cap; x.cap = n;
+            n = num_elements; num_elements = x.num_elements; x.num_elements = n;
+            n = growth_left; growth_left = x.growth_left; x.growth_left = n;
+            float f = max_load; max_load = x.max_load; x.max_load = f;
+            hasher h = hash; hash = x.hash; x.hash = h;
+            key_equal e = equals; equals = x.equals; x.equals = e;
+        }
+
+        pair<iterator, bool> insert_unique(const value_type& v) {
+            const key_type& k = get_key(v);
+            size_t h = mix(hash(k));
+            size_type i = find_index(k, h);
+            if(i != cap)
+                return pair<iterator, bool>(iterator(ctrl + i, slots + i), false);
+            i = prepare_insert(h);
+            try {
+                construct(&slots[i], v);
+            }
+            catch(...) {
+                cancel_insert(i);
+                throw;
+            }
+            return pair<iterator, bool>(iterator(ctrl + i, slots + i), true);
+        }
+        template <class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            for(; first != last; ++first)
+                insert_unique(*first);
+        }
+        //找不到键值为k的元素时插入一个由obj构造的元素
+        reference find_or_insert(const value_type& obj) { return *insert_unique(obj).first; }
+
+        //组内有空槽时，没有探测越过过这个槽，可以直接置空；否则留下删除标记
+        void erase(const_iterator position) {
+            size_type i = position.slot - slots;
+            destroy(&slots[i]);
+            --num_elements;
+            uint64_t empty_after = _swiss_group(ctrl + i).match_empty();
+            uint64_t empty_before = _swiss_group(ctrl + ((i - _swiss_group::width) & cap)).match_empty();
+            bool was_never_full = empty_before && empty_after &&
+                                  _swiss_lowest(empty_after) + _swiss_leading(empty_before) < size_type(_swiss_group::width);
+            set_ctrl(i, was_never_full ? _swiss_ctrl(_swiss_empty) : _swiss_ctrl(_swiss_deleted));
+            if(was_never_full) ++growth_left;
+        }
+        size_type erase(const key_type& k) {
+            size_type i = find_index(k, mix(hash(k)));
+            if(i == cap) return 0;
+            erase(const_iterator(ctrl + i, slots + i));
+            return 1;
+        }
+        void erase(const_iterator first, const_iterator last) {
+            while(first != last)
+                erase(first++);
+        }
+        //保留容量，清除所有元素和删除标记
+        void clear() {
+            if(cap == 0) return;
+            destroy_slots();
+            for(size_type i = 0; i != cap + _swiss_group::width; ++i)
+                ctrl[i] = _swiss_empty;
+            ctrl[cap] = _swiss_sentinel;
+            num_elements = 0;
+            growth_left = growth_of(cap);
+        }
+
+        iterator find(const key_type& k) {
+            size_type i = find_index(k, mix(hash(k)));
+            return iterator(ctrl + i, slots + i);
+        }
+        const_iterator find(const key_type& k) const {
+            size_type i = find_index(k, mix(hash(k)));
+            return const_iterator(ctrl + i, slots + i);
+        }
+        size_type count(const key_type& k) const { return find_index(k, mix(hash(k))) == cap ? 0 : 1; }
+        pair<iterator, iterator> equal_range(const key_type& k) {
+            iterator first = find(k);
+            if(first == end()) return pair<iterator, iterator>(first, first);
+            iterator last = first;
+            return pair<iterator, iterator>(first, ++last);
+        }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            const_iterator first = find(k);
+            if(first == end()) return pair<const_iterator, const_iterator>(first, first);
+            const_iterator last = first;
+            return pair<const_iterator, const_iterator>(first, ++last);
+        }
+
+        //元素相同即相等，与次序无关
+        friend bool operator== (const flat_hash_table& x, const flat_hash_table& y) {
+            if(x.size() != y.size()) return false;
+            for(const_iterator it = x.begin(); it != x.end(); ++it) {
+                const_iterator j = y.find(x.get_key(*it));
+                if(j == y.end() || !(*j == *it)) return false;
+            }
+            return true;
+        }
+    };
+}
+#endif //MY_STL_FLAT_HASH_TABLE_H
@@ -0,0 +1,279 @@
+#ifndef MY_STL_FLAT_MAP_H
+#define MY_STL_FLAT_MAP_H
+//flat_map：键与值分别有序地存放在两个vector中(SoA)，键值不允许重复
+//查找只扫描连续的键，不把值拉进cache；适合构建一次、查询多次的只读表
+//单个插入删除为O(n)，区间插入按批归并，每批原有元素只移动一次
+//元素并不以pair的形式存在，迭代器解引用得到pair<const Key&, T&>，插入删除会使所有迭代器失效
+#include "vector.h"
+#include "functional.h"
+#include "pair.h"
+#include "flat_tree.h"
+namespace my_stl{
+    template <class Key, class T, class Ref, class Ptr>
+    struct _flat_map_iterator {
+        typedef _flat_map_iterator<Key, T, T&, T*> iterator;
+        typedef _flat_map_iterator<Key, T, Ref, Ptr> self;
+        typedef random_access_iterator_tag iterator_category;
+        typedef pair<Key, T> value_type;
+        typedef pair<const Key&, Ref> reference;
+        //operator->返回的代理，持有一个reference
+        struct pointer {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        const Key* key;
+        Ptr value;
+
+        _flat_map_iterator() {}
+        _flat_map_iterator(const Key* k, Ptr v) : key(k), value(v) {}
+        _flat_map_iterator(const iterator& x) : key(x.key), value(x.value) {}
+
+        bool operator== (const self& x) const { return key == x.key; }
+        bool operator!= (const self& x) const { return key != x.key; }
+        bool operator< (const self& x) const { return key < x.key; }
+        reference operator*() const { return reference(*key, *value); }
+        pointer operator->() const {
+            pointer p = { **this };
+            return p;
+        }
+        reference operator[] (difference_type n) const { return *(*this + n); }
+        self& operator++() {
+            ++key;
+            ++value;
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--() {
+            --key;
+            --value;
+            return *this;
+        }
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+        self& operator+= (difference_type n) {
+            key += n;
+            value += n;
+            return *this;
+        }
+        self& operator-= (difference_type n) { return *this += -n; }
+        self operator+ (difference_type n) const {
+            self tmp = *this;
+            return tmp += n;
+        }
+        self operator- (difference_type n) const {
+            self tmp = *this;
+            return tmp -= n;
+        }
+        difference_type operator- (const self& x) const { return key - x.key; }
+    };
+
+    template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+    class flat_map {
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<Key, T> value_type;
+        typedef Compare key_compare;
+        //按键值比较两个元素
+        class value_compare : public binary_function<value_type, value_type, bool> {
+            friend class flat_map;
+        protected:
+            Compare comp;
+            value_compare(Compare c) : comp(c) {}
+        public:
+            bool operator() (const value_type& x, const value_type& y) const { return comp(x.first, y.first); }
+        };
+        typedef _flat_map_iterator<Key, T, T&, T*> iterator;
+        typedef _flat_map_iterator<Key, T, const T&, const T*> const_iterator;
+        typedef typename iterator::reference reference;
+        typedef typename const_iterator::reference const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+    protected:
+        vector<Key, Alloc> keys;
+        vector<T, Alloc> values;
+        Compare comp;
+
+        //下标n处插入(k, v)
+        void insert_at(size_type n, const Key& k, const T& v) {
+            keys.insert(keys.begin() + n, k);
+            try {
+                values.insert(values.begin() + n, v);
+            }
+            catch(...) {
+                keys.erase(keys.begin() + n);
+                throw;
+            }
+        }
+        size_type lower_index(const key_type& k) const {
+            return _flat_lower_bound(keys.begin(), keys.size(), k, comp) - keys.begin();
+        }
+        size_type find_index(const key_type& k) const {
+            size_type i = lower_index(k);
+            return (i == size() || comp(k, keys[i])) ? size() : i;
+        }
+    public:
+        flat_map() : comp(Compare()) {}
+        explicit flat_map(const Compare& x) : comp(x) {}
+        template <class InputIterator>
+        flat_map(InputIterator first, InputIterator last) : comp(Compare()) { insert(first, last); }
+        template <class InputIterator>
+        flat_map(InputIterator first, InputIterator last, const Compare& x) : comp(x) { insert(first, last); }
+
+        key_compare key_comp() const { return comp; }
+        value_compare value_comp() const { return value_compare(comp); }
+        iterator begin() { return iterator(keys.begin(), values.begin()); }
+        iterator end() { return iterator(keys.end(), values.end()); }
+        const_iterator begin() const { return const_iterator(keys.begin(), values.begin()); }
+        const_iterator end() const { return const_iterator(keys.end(), values.end()); }
+        bool empty() const { return keys.empty(); }
+        size_type size() const { return keys.size(); }
+        size_type max_size() const { return size_type(-1) / (sizeof(Key) + sizeof(T)); }
+        size_type capacity() const { return keys.capacity(); }
+        void reserve(size_type n) {
+            keys.reserve(n);
+            values.reserve(n);
+        }
+        //下标访问有序的键和值
+        const Key& key_at(size_type n) const { return keys[n]; }
+        T& value_at(size_type n) { return values[n]; }
+        const T& value_at(size_type n) const { return values[n]; }
+        T& operator[] (const key_type& k) {
+            size_type i = lower_index(k);
+            if(i == size() || comp(k, keys[i]))
+                insert_at(i, k, T());
+            return values[i];
+        }
+        void swap(flat_map& x) {
+            keys.swap(x.keys);
+            values.swap(x.values);
+            Compare tmp = comp;
+            comp = x.comp;
+            x.comp = tmp;
+        }
+
+        pair<iterator, bool> insert(const value_type& x) {
+            size_type i = lower_index(x.first);
+            if(i != size() && !comp(x.first, keys[i]))
+                return pair<iterator, bool>(begin() + i, false);
+            insert_at(i, x.first, x.second);
+            return pair<iterator, bool>(begin() + i, true);
+        }
+        //提示位置被忽略，为了与map的接口一致
+        iterator insert(iterator, const value_type& x) { return insert(x).first; }
+        //批量插入：新元素先收集、按键稳定排序并去重，再从后往前与原有元素归并
+        //同一批中键相等的元素只保留第一个，已存在的键不被覆盖
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            vector<value_type, Alloc> batch;
+            for(; first != last; ++first)
+                batch.push_back(*first);
+            size_type m = batch.size();
+            if(m == 0) return;
+            vector<value_type, Alloc> buf(batch);
+            value_compare vc(comp);
+            _flat_stable_sort(batch.begin(), buf.begin(), m, vc);
+            value_type* b = batch.begin();
+            size_type k = 0;
+            for(size_type i = 0; i != m; ++i) {
+                if(i > 0 && !comp(b[i - 1].first, b[i].first)) continue;
+                if(find_index(b[i].first) != size()) continue;
+                b[k++] = b[i];
+            }
+            if(k == 0) return;
+            size_type n = size();
+            reserve(n + k);
+            keys.insert(keys.end(), k, b[0].first);
+            values.insert(values.end(), k, b[0].second);
+            Key* ko = keys.begin() + n + k;
+            T* vo = values.begin() + n + k;
+            while(k != 0) {
+                if(n != 0 && comp(b[k - 1].first, keys[n - 1])) {
+                    --n;
+                    *--ko = keys[n];
+                    *--vo = values[n];
+                }else {
+                    --k;
+                    *--ko = b[k].first;
+                    *--vo = b[k].second;
+                }
+            }
+        }
+        //由按键排好序且键无重复的区间重建，原有元素被清除
+        template <class InputIterator>
+        void build_from_sorted(InputIterator first, InputIterator last) {
+            clear();
+            for(; first != last; ++first) {
+                keys.push_back((*first).first);
+                values.push_back((*first).second);
+            }
+        }
+        void erase(iterator position) {
+            size_type n = position - begin();
+            keys.erase(keys.begin() + n);
+            values.erase(values.begin() + n);
+        }
+        size_type erase(const key_type& k) {
+            size_type i = find_index(k);
+            if(i == size()) return 0;
+            erase(begin() + i);
+            return 1;
+        }
+        void erase(iterator first, iterator last) {
+            size_type f = first - begin(), l = last - begin();
+            keys.erase(keys.begin() + f, keys.begin() + l);
+            values.erase(values.begin() + f, values.begin() + l);
+        }
+        void clear() {
+            keys.clear();
+            values.clear();
+        }
+
+        iterator find(const key_type& k) { return begin() + find_index(k); }
+        const_iterator find(const key_type& k) const { return begin() + find_index(k); }
+        size_type count(const key_type& k) const { return find_index(k) == size() ? 0 : 1; }
+        iterator lower_bound(const key_type& k) { return begin() + lower_index(k); }
+        const_iterator lower_bound(const key_type& k) const { return begin() + lower_index(k); }
+        iterator upper_bound(const key_type& k) {
+            return begin() + (_flat_upper_bound(keys.begin(), keys.size(), k, comp) - keys.begin());
+        }
+        const_iterator upper_bound(const key_type& k) const {
+            return begin() + (_flat_upper_bound(keys.begin(), keys.size(), k, comp) - keys.begin());
+        }
+        pair<iterator, iterator> equal_range(const key_type& k) {
+            return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+        }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+        }
+
+        friend bool operator== (const flat_map& x, const flat_map& y) {
+            if(x.size() != y.size()) return false;
+            for(size_type i = 0; i != x.size(); ++i)
+                if(!(x.keys[i] == y.keys[i]) || !(x.values[i] == y.values[i])) return false;
+            return true;
+        }
+        friend bool operator< (const flat_map& x, const flat_map& y) {
+            size_type n = x.size() < y.size() ? x.size() : y.size();
+            for(size_type i = 0; i != n; ++i) {
+                if(x.keys[i] < y.keys[i]) return true;
+                if(y.keys[i] < x.keys[i]) return false;
+                if(x.values[i] < y.values[i]) return true;
+                if(y.values[i] < x.values[i]) return false;
+            }
+            return x.size() < y.size();
+        }
+    };
+}
+#endif //MY_STL_FLAT_MAP_H
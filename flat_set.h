@@ -0,0 +1,139 @@
+#ifndef MY_STL_FLAT_SET_H
+#define MY_STL_FLAT_SET_H
+//flat_set：元素有序地连续存放在vector中，键值不允许重复
+//查找只访问连续内存，适合构建一次、查询多次的只读表；单个插入删除要移动其后的元素，为O(n)
+//区间插入按批归并，每批原有元素只移动一次
+//插入删除会使所有迭代器失效
+#include "vector.h"
+#include "functional.h"
+#include "pair.h"
+#include "flat_tree.h"
+namespace my_stl{
+    template <class Key, class Compare = less<Key>, class Alloc = alloc>
+    class flat_set {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+        typedef const value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef const value_type& reference;
+        typedef const value_type& const_reference;
+        //不允许通过迭代器改变元素值，iterator也是const_iterator
+        typedef const value_type* iterator;
+        typedef const value_type* const_iterator;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+    protected:
+        typedef vector<Key, Alloc> rep_type;
+        rep_type c;
+        Compare comp;
+
+        Key* mutable_begin() { return c.begin(); }
+    public:
+        flat_set() : comp(Compare()) {}
+        explicit flat_set(const Compare& x) : comp(x) {}
+        template <class InputIterator>
+        flat_set(InputIterator first, InputIterator last) : comp(Compare()) { insert(first, last); }
+        template <class InputIterator>
+        flat_set(InputIterator first, InputIterator last, const Compare& x) : comp(x) { insert(first, last); }
+
+        key_compare key_comp() const { return comp; }
+        value_compare value_comp() const { return comp; }
+        iterator begin() const { return c.begin(); }
+        iterator end() const { return c.end(); }
+        bool empty() const { return c.empty(); }
+        size_type size() const { return c.size(); }
+        size_type max_size() const { return size_type(-1) / sizeof(Key); }
+        size_type capacity() const { return c.capacity(); }
+        void reserve(size_type n) { c.reserve(n); }
+        reference operator[] (size_type n) const { return c[n]; }
+        void swap(flat_set& x) {
+            c.swap(x.c);
+            Compare tmp = comp;
+            comp = x.comp;
+            x.comp = tmp;
+        }
+
+        pair<iterator, bool> insert(const value_type& x) {
+            iterator i = lower_bound(x);
+            if(i != end() && !comp(x, *i))
+                return pair<iterator, bool>(i, false);
+            size_type n = i - begin();
+            c.insert(mutable_begin() + n, x);
+            return pair<iterator, bool>(begin() + n, true);
+        }
+        //提示位置被忽略，为了与set的接口一致
+        iterator insert(iterator, const value_type& x) { return insert(x).first; }
+        //批量插入：新元素先收集、稳定排序并去重，再与原有元素归并；同一批中相等的元素只保留第一个
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            rep_type batch;
+            for(; first != last; ++first)
+                batch.push_back(*first);
+            size_type m = batch.size();
+            if(m == 0) return;
+            rep_type buf(batch);
+            _flat_stable_sort(batch.begin(), buf.begin(), m, comp);
+            Key* b = batch.begin();
+            size_type k = 0;
+            for(size_type i = 0; i != m; ++i) {
+                if(i > 0 && !comp(b[i - 1], b[i])) continue;
+                iterator j = lower_bound(b[i]);
+                if(j != end() && !comp(b[i], *j)) continue;
+                b[k++] = b[i];
+            }
+            if(k == 0) return;
+            size_type n = size();
+            c.reserve(n + k);
+            c.insert(c.end(), k, b[0]);
+            _flat_merge_backward(mutable_begin(), n, b, k, comp);
+        }
+        //由已排序且无重复的区间重建，原有元素被清除
+        template <class InputIterator>
+        void build_from_sorted(InputIterator first, InputIterator last) {
+            c.clear();
+            for(; first != last; ++first)
+                c.push_back(*first);
+        }
+        void erase(iterator position) { c.erase(mutable_begin() + (position - begin())); }
+        size_type erase(const key_type& x) {
+            iterator i = find(x);
+            if(i == end()) return 0;
+            erase(i);
+            return 1;
+        }
+        void erase(iterator first, iterator last) {
+            c.erase(mutable_begin() + (first - begin()), mutable_begin() + (last - begin()));
+        }
+        void clear() { c.clear(); }
+
+        iterator lower_bound(const key_type& x) const { return _flat_lower_bound(begin(), size(), x, comp); }
+        iterator upper_bound(const key_type& x) const { return _flat_upper_bound(begin(), size(), x, comp); }
+        pair<iterator, iterator> equal_range(const key_type& x) const {
+            return pair<iterator, iterator>(lower_bound(x), upper_bound(x));
+        }
+        iterator find(const key_type& x) const {
+            iterator i = lower_bound(x);
+            return (i == end() || comp(x, *i)) ? end() : i;
+        }
+        size_type count(const key_type& x) const { return find(x) == end() ? 0 : 1; }
+
+        friend bool operator== (const flat_set& x, const flat_set& y) {
+            if(x.size() != y.size()) return false;
+            for(iterator i = x.begin(), j = y.begin(); i != x.end(); ++i, ++j)
+                if(!(*i == *j)) return false;
+            return true;
+        }
+        friend bool operator< (const flat_set& x, const flat_set& y) {
+            iterator i = x.begin(), j = y.begin();
+            for(; i != x.end() && j != y.end(); ++i, ++j) {
+                if(*i < *j) return true;
+                if(*j < *i) return false;
+            }
+            return i == x.end() && j != y.end();
+        }
+    };
+}
+#endif //MY_STL_FLAT_SET_H
@@ -0,0 +1,80 @@
+#ifndef MY_STL_FLAT_TREE_H
+#define MY_STL_FLAT_TREE_H
+//flat_set与flat_map共用的有序数组算法
+//查找用无分支二分：每轮只按比较结果挑选下一段的起点，编译为条件传送，没有难以预测的分支
+//批量插入先把新元素排好序、去重，再从后往前与原有元素归并，整批只移动一次原有元素
+#include <cstddef>
+namespace my_stl{
+    //[first, first + n)中第一个不小于k的位置
+    template <class T, class Key, class Compare>
+    inline const T* _flat_lower_bound(const T* first, size_t n, const Key& k, Compare comp) {
+        if(n == 0) return first;
+        while(n > 1) {
+            size_t half = n / 2;
+            first = comp(first[half], k) ? first + half : first;
+            n -= half;
+        }
+        return first + (comp(*first, k) ? 1 : 0);
+    }
+    //[first, first + n)中第一个大于k的位置
+    template <class T, class Key, class Compare>
+    inline const T* _flat_upper_bound(const T* first, size_t n, const Key& k, Compare comp) {
+        if(n == 0) return first;
+        while(n > 1) {
+            size_t half = n / 2;
+            first = comp(k, first[half]) ? first : first + half;
+            n -= half;
+        }
+        return first + (comp(k, *first) ? 0 : 1);
+    }
+
+    //稳定排序[a, a + n)：每16个元素一段先插入排序，再两两归并；buf为n个已构造的元素，作为归并的辅助空间
+    template <class T, class Compare>
+    void _flat_stable_sort(T* a, T* buf, size_t n, Compare comp) {
+        const size_t run = 16;
+        for(size_t lo = 0; lo < n; lo += run) {
+            size_t hi = lo + run < n ? lo + run : n;
+            for(size_t i = lo + 1; i < hi; ++i) {
+                T x = a[i];
+                size_t j = i;
+                for(; j > lo && comp(x, a[j - 1]); --j)
+                    a[j] = a[j - 1];
+                a[j] = x;
+            }
+        }
+        T* from = a;
+        T* to = buf;
+        for(size_t width = run; width < n; width *= 2) {
+            for(size_t lo = 0; lo < n; lo += 2 * width) {
+                size_t mid = lo + width < n ? lo + width : n;
+                size_t hi = lo + 2 * width < n ? lo + 2 * width : n;
+                size_t i = lo, j = mid, k = lo;
+                while(i < mid && j < hi) {
+                    //相等时取左边的，保持稳定
+                    if(comp(from[j], from[i])) to[k++] = from[j++];
+                    else to[k++] = from[i++];
+                }
+                while(i < mid) to[k++] = from[i++];
+                while(j < hi) to[k++] = from[j++];
+            }
+            T* tmp = from;
+            from = to;
+            to = tmp;
+        }
+        if(from != a) {
+            for(size_t i = 0; i != n; ++i)
+                a[i] = from[i];
+        }
+    }
+    //把已排序的b[0, m)和已排序的a[0, n)从后往前归并到a[0, n + m)，a的容量至少n + m且已构造
+    //键值相等时a中的元素排在前面
+    template <class T, class U, class Compare>
+    void _flat_merge_backward(T* a, size_t n, const U* b, size_t m, Compare comp) {
+        T* out = a + n + m;
+        while(m != 0) {
+            if(n != 0 && comp(b[m - 1], a[n - 1])) *--out = a[--n];
+            else *--out = b[--m];
+        }
+    }
+}
+#endif //MY_STL_FLAT_TREE_H
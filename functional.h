@@ -0,0 +1,41 @@
+#ifndef MY_STL_FUNCTIONAL_H
+#define MY_STL_FUNCTIONAL_H
+//函数对象
+namespace my_stl{
+    template <class Arg, class Result>
+    struct unary_function {
+        typedef Arg argument_type;
+        typedef Result result_type;
+    };
+    template <class Arg1, class Arg2, class Result>
+    struct binary_function {
+        typedef Arg1 first_argument_type;
+        typedef Arg2 second_argument_type;
+        typedef Result result_type;
+    };
+
+    template <class T>
+    struct equal_to : public binary_function<T, T, bool> {
+        bool operator() (const T& x, const T& y) const { return x == y; }
+    };
+    template <class T>
+    struct less : public binary_function<T, T, bool> {
+        bool operator() (const T& x, const T& y) const { return x < y; }
+    };
+    template <class T>
+    struct greater : public binary_function<T, T, bool> {
+        bool operator() (const T& x, const T& y) const { return y < x; }
+    };
+
+    //证同：返回参数本身，set以元素自身为键
+    template <class T>
+    struct identity : public unary_function<T, T> {
+        const T& operator() (const T& x) const { return x; }
+    };
+    //取pair的first，map以pair的first为键
+    template <class Pair>
+    struct select1st : public unary_function<Pair, typename Pair::first_type> {
+        const typename Pair::first_type& operator() (const Pair& x) const { return x.first; }
+    };
+}
+#endif //MY_STL_FUNCTIONAL_H
@@ -0,0 +1,60 @@
+#ifndef MY_STL_HASH_FUN_H
+#define MY_STL_HASH_FUN_H
+//散列函数，沿用SGI STL的hash<>：整数直接以自身为散列值，字符串逐字符累乘
+//其它类型(例如std::string)需要使用者自行提供散列函数
+#include <cstddef>
+namespace my_stl{
+    template <class Key> struct hash {};
+
+    inline size_t _stl_hash_string(const char* s) {
+        unsigned long h = 0;
+        for(; *s; ++s)
+            h = 5 * h + *s;
+        return size_t(h);
+    }
+
+    template <> struct hash<char*> {
+        size_t operator() (const char* s) const { return _stl_hash_string(s); }
+    };
+    template <> struct hash<const char*> {
+        size_t operator() (const char* s) const { return _stl_hash_string(s); }
+    };
+    template <> struct hash<char> {
+        size_t operator() (char x) const { return x; }
+    };
+    template <> struct hash<unsigned char> {
+        size_t operator() (unsigned char x) const { return x; }
+    };
+    template <> struct hash<signed char> {
+        size_t operator() (signed char x) const { return x; }
+    };
+    template <> struct hash<short> {
+        size_t operator() (short x) const { return x; }
+    };
+    template <> struct hash<unsigned short> {
+        size_t operator() (unsigned short x) const { return x; }
+    };
+    template <> struct hash<int> {
+        size_t operator() (int x) const { return x; }
+    };
+    template <> struct hash<unsigned int> {
+        size_t operator() (unsigned int x) const { return x; }
+    };
+    template <> struct hash<long> {
+        size_t operator() (long x) const { return x; }
+    };
+    template <> struct hash<unsigned long> {
+        size_t operator() (unsigned long x) const { return x; }
+    };
+    template <> struct hash<long long> {
+        size_t operator() (long long x) const { return size_t(x); }
+    };
+    template <> struct hash<unsigned long long> {
+        size_t operator() (unsigned long long x) const { return size_t(x); }
+    };
+    //指针按地址散列
+    template <class T> struct hash<T*> {
+        size_t operator() (T* p) const { return size_t(p); }
+    };
+}
+#endif //MY_STL_HASH_FUN_H
@@ -1,76 +1,262 @@
 #ifndef MY_STL_HEAP_H
 #define MY_STL_HEAP_H
 #include "iterator.h"
+#include "functional.h"
+//堆算法，默认为二叉堆；push_heap<Arity>等可以指定为Arity叉堆
+//节点i的子节点为Arity * i + 1 ... Arity * i + Arity，父节点为(i - 1) / Arity
+//叉数越大树越矮，下沉时每层多比较几次，但同一节点的子节点连续存放，访问的cache line更少
+//不带comp的版本以operator<比较，堆顶为最大的元素；带comp的版本堆顶为comp意义下最大的元素
 namespace my_stl{
     //堆的插入向上调整
-    template <class RandomAccessIterator, class Distance, class T>
-    void _push_heap(RandomAccessIterator first, Distance holeIndex, Distance topIndex, T value) {
-        Distance parent = (holeIndex - 1) / 2;//父节点
-        while(holeIndex > topIndex && *(first + parent) < value) {
+    template <size_t Arity, class RandomAccessIterator, class Distance, class T, class Compare>
+    void _push_heap(RandomAccessIterator first, Distance holeIndex, Distance topIndex, T value, Compare comp) {
+        Distance parent = (holeIndex - 1) / Distance(Arity);//父节点
+        while(holeIndex > topIndex && comp(*(first + parent), value)) {
             *(first + holeIndex) = *(first + parent);
             holeIndex = parent;
-            parent = (holeIndex - 1) / 2;
+            parent = (holeIndex - 1) / Distance(Arity);
         }
         *(first + holeIndex) = value;
     }
-    template <class RandomAccessIterator, class Distance, class T>
-    inline void _push_heap_aux(RandomAccessIterator first, RandomAccessIterator last, Distance*, T*) {
-        _push_heap(first, Distance((last - first) - 1), Distance(0), T(*(last - 1)));
+    template <size_t Arity, class RandomAccessIterator, class Distance, class T, class Compare>
+    inline void _push_heap_aux(RandomAccessIterator first, RandomAccessIterator last, Distance*, T*, Compare comp) {
+        _push_heap<Arity>(first, Distance((last - first) - 1), Distance(0), T(*(last - 1)), comp);
+    }
+    template <size_t Arity, class RandomAccessIterator, class T>
+    inline void _push_heap_aux(RandomAccessIterator first, RandomAccessIterator last, T*) {
+        _push_heap_aux<Arity>(first, last, distance_type(first), (T*) 0, less<T>());
+    }
+    template <size_t Arity, class RandomAccessIterator, class Compare>
+    inline void push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        _push_heap_aux<Arity>(first, last, distance_type(first), value_type(first), comp);
+    }
+    template <size_t Arity, class RandomAccessIterator>
+    inline void push_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        _push_heap_aux<Arity>(first, last, value_type(first));
+    }
+    template <class RandomAccessIterator, class Compare>
+    inline void push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        push_heap<2>(first, last, comp);
     }
     template <class RandomAccessIterator>
     inline void push_heap(RandomAccessIterator first, RandomAccessIterator last) {
-        _push_heap_aux(first, last, distance_type(first), value_type(first));
+        push_heap<2>(first, last);
+    }
+    //[child, child + n)中最大的子节点，相等时取靠后的一个
+    template <class RandomAccessIterator, class Distance, class Compare>
+    inline Distance _largest_child(RandomAccessIterator first, Distance child, Distance n, Compare comp) {
+        Distance largest = child;
+        for(Distance i = child + 1; i != child + n; ++i)
+            if(!comp(*(first + i), *(first + largest)))
+                largest = i;
+        return largest;
     }
-    //堆的删除向下调整
-    template <class RandomAccessIterator, class Distance, class T>
-    void _adjust_heap(RandomAccessIterator first, Distance holeIndex, Distance len, T value) {
+    //堆的删除向下调整：空洞一路沿较大的子节点下沉到底，再把value上溯到合适位置
+    template <size_t Arity, class RandomAccessIterator, class Distance, class T, class Compare>
+    void _adjust_heap(RandomAccessIterator first, Distance holeIndex, Distance len, T value, Compare comp) {
         Distance topIndex = holeIndex;
-        Distance secondChild = 2 * holeIndex + 2;
-        while(secondChild < len) {
-            if(*(first + secondChild) < *(first + (secondChild - 1)))
-                secondChild--;
-            *(first + holeIndex) = *(first + secondChild);
-            holeIndex = secondChild;
-            secondChild = 2 * secondChild + 2;
+        Distance child = Distance(Arity) * holeIndex + 1; //第一个子节点
+        while(child + Distance(Arity) <= len) {
+            Distance largest = _largest_child(first, child, Distance(Arity), comp);
+            *(first + holeIndex) = *(first + largest);
+            holeIndex = largest;
+            child = Distance(Arity) * largest + 1;
         }
-        if(secondChild == len) {
-            *(first + holeIndex) = *(first + (secondChild - 1));
-            holeIndex = secondChild - 1;
+        if(child < len) {
+            //最后一个节点的子节点不满Arity个
+            Distance largest = _largest_child(first, child, len - child, comp);
+            *(first + holeIndex) = *(first + largest);
+            holeIndex = largest;
         }
-        _push_heap(first, holeIndex, topIndex, value);
+        _push_heap<Arity>(first, holeIndex, topIndex, value, comp);
     }
-    template <class RandomAccessIterator, class T, class Distance>
-    inline void _pop_heap(RandomAccessIterator first, RandomAccessIterator last, RandomAccessIterator result, T value, Distance*) {
+    template <size_t Arity, class RandomAccessIterator, class T, class Distance, class Compare>
+    inline void _pop_heap(RandomAccessIterator first, RandomAccessIterator last, RandomAccessIterator result,
+                          T value, Distance*, Compare comp) {
         *result = *first;
-        _adjust_heap(first, Distance(0), Distance(last - first), value);
+        _adjust_heap<Arity>(first, Distance(0), Distance(last - first), value, comp);
     }
-    template <class RandomAccessIterator, class T>
-    inline void _pop_heap_aux(RandomAccessIterator first, RandomAccessIterator last) {
-        _pop_heap(first, last - 1, last - 1, T(*(last - 1)), distance_type(first));
+    template <size_t Arity, class RandomAccessIterator, class T, class Compare>
+    inline void _pop_heap_aux(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+        _pop_heap<Arity>(first, last - 1, last - 1, T(*(last - 1)), distance_type(first), comp);
     }
-    template <class RandomAccessIterator>
+    template <size_t Arity, class RandomAccessIterator, class T>
+    inline void _pop_heap_aux(RandomAccessIterator first, RandomAccessIterator last, T*) {
+        _pop_heap_aux<Arity>(first, last, (T*) 0, less<T>());
+    }
+    template <size_t Arity, class RandomAccessIterator, class Compare>
+    inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        _pop_heap_aux<Arity>(first, last, value_type(first), comp);
+    }
+    template <size_t Arity, class RandomAccessIterator>
     inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last) {
-        _pop_heap_aux(first, last, value_type(first));
+        _pop_heap_aux<Arity>(first, last, value_type(first));
+    }
+    template <class RandomAccessIterator, class Compare>
+    inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        pop_heap<2>(first, last, comp);
     }
     template <class RandomAccessIterator>
+    inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        pop_heap<2>(first, last);
+    }
+    template <size_t Arity, class RandomAccessIterator, class Compare>
+    void sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        while(last - first > 1)
+            pop_heap<Arity>(first, last--, comp);
+    }
+    template <size_t Arity, class RandomAccessIterator>
     void sort_heap(RandomAccessIterator first, RandomAccessIterator last) {
         while(last - first > 1)
-            pop_heap(first, last--);
+            pop_heap<Arity>(first, last--);
     }
-    template <class RandomAccessIterator, class T, class Distance>
-    void _make_heap(RandomAccessIterator first, RandomAccessIterator last, T*, Distance*) {
+    template <class RandomAccessIterator, class Compare>
+    inline void sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        sort_heap<2>(first, last, comp);
+    }
+    template <class RandomAccessIterator>
+    inline void sort_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        sort_heap<2>(first, last);
+    }
+    template <size_t Arity, class RandomAccessIterator, class T, class Distance, class Compare>
+    void _make_heap(RandomAccessIterator first, RandomAccessIterator last, T*, Distance*, Compare comp) {
         if(last - first < 2) return;
         Distance len = last - first;
-        Distance parent = (len - 2) / 2;
+        Distance parent = (len - 2) / Distance(Arity); //最后一个有子节点的节点
         while(true){
-            _adjust_heap(first, parent, len, T(*(first + parent)));
+            _adjust_heap<Arity>(first, parent, len, T(*(first + parent)), comp);
             if(parent == 0) return;
             parent--;
         }
     }
+    template <size_t Arity, class RandomAccessIterator, class T, class Distance>
+    inline void _make_heap(RandomAccessIterator first, RandomAccessIterator last, T*, Distance*) {
+        _make_heap<Arity>(first, last, (T*) 0, (Distance*) 0, less<T>());
+    }
+    template <size_t Arity, class RandomAccessIterator, class Compare>
+    inline void make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        _make_heap<Arity>(first, last, value_type(first), distance_type(first), comp);
+    }
+    template <size_t Arity, class RandomAccessIterator>
+    inline void make_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        _make_heap<Arity>(first, last, value_type(first), distance_type(first));
+    }
+    template <class RandomAccessIterator, class Compare>
+    inline void make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        make_heap<2>(first, last, comp);
+    }
     template <class RandomAccessIterator>
     inline void make_heap(RandomAccessIterator first, RandomAccessIterator last) {
-        _make_heap(first, last, value_type(first), distance_type(first));
+        make_heap<2>(first, last);
+    }
+
+    //以下为基于堆的选择算法，都只维护一个大小为k的堆，O(n log k)，不必整体排序
+    //把comp反过来，用来在同一段区间上建“小顶堆”
+    template <class Compare>
+    struct _heap_reverse_compare {
+        Compare comp;
+        explicit _heap_reverse_compare(const Compare& c) : comp(c) {}
+        template <class T>
+        bool operator() (const T& x, const T& y) const { return comp(y, x); }
+    };
+
+    //部分排序：把[first, last)中最小的middle - first个元素按递增顺序放到[first, middle)
+    //[first, middle)先建成大顶堆，之后每个比堆顶小的元素与堆顶交换并下沉
+    template <class RandomAccessIterator, class T, class Compare>
+    void _partial_sort(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last,
+                       T*, Compare comp) {
+        make_heap<2>(first, middle, comp);
+        for(RandomAccessIterator i = middle; i < last; ++i)
+            if(comp(*i, *first))
+                _pop_heap<2>(first, middle, i, T(*i), distance_type(first), comp);
+        sort_heap<2>(first, middle, comp);
+    }
+    template <class RandomAccessIterator, class T>
+    inline void _partial_sort(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, T*) {
+        _partial_sort(first, middle, last, (T*) 0, less<T>());
+    }
+    template <class RandomAccessIterator, class Compare>
+    inline void partial_sort(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last,
+                             Compare comp) {
+        _partial_sort(first, middle, last, value_type(first), comp);
+    }
+    template <class RandomAccessIterator>
+    inline void partial_sort(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last) {
+        _partial_sort(first, middle, last, value_type(first));
+    }
+
+    //同上，但输入只需是InputIterator(只读一遍)，结果写到[result_first, result_last)，返回结果的尾
+    template <class InputIterator, class RandomAccessIterator, class Distance, class T, class Compare>
+    RandomAccessIterator _partial_sort_copy(InputIterator first, InputIterator last,
+                                            RandomAccessIterator result_first, RandomAccessIterator result_last,
+                                            Distance*, T*, Compare comp) {
+        if(result_first == result_last) return result_last;
+        RandomAccessIterator result_real_last = result_first;
+        for(; first != last && result_real_last != result_last; ++first, ++result_real_last)
+            *result_real_last = *first;
+        make_heap<2>(result_first, result_real_last, comp);
+        for(; first != last; ++first)
+            if(comp(*first, *result_first))
+                _adjust_heap<2>(result_first, Distance(0), Distance(result_real_last - result_first), T(*first), comp);
+        sort_heap<2>(result_first, result_real_last, comp);
+        return result_real_last;
+    }
+    template <class InputIterator, class RandomAccessIterator, class Compare>
+    inline RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last,
+                                                  RandomAccessIterator result_first, RandomAccessIterator result_last,
+                                                  Compare comp) {
+        return _partial_sort_copy(first, last, result_first, result_last,
+                                  distance_type(result_first), value_type(result_first), comp);
+    }
+    template <class InputIterator, class RandomAccessIterator, class Distance, class T>
+    inline RandomAccessIterator _partial_sort_copy(InputIterator first, InputIterator last,
+                                                   RandomAccessIterator result_first, RandomAccessIterator result_last,
+                                                   Distance*, T*) {
+        return _partial_sort_copy(first, last, result_first, result_last, (Distance*) 0, (T*) 0, less<T>());
+    }
+    template <class InputIterator, class RandomAccessIterator>
+    inline RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last,
+                                                  RandomAccessIterator result_first, RandomAccessIterator result_last) {
+        return _partial_sort_copy(first, last, result_first, result_last,
+                                  distance_type(result_first), value_type(result_first));
+    }
+
+    //把排序后应位于nth的元素放到nth处，其前的元素都不大于它，其后的都不小于它
+    //在较短的一侧建堆：nth靠前时[first, nth]为大顶堆，保留最小的k + 1个；靠后时[nth, last)为小顶堆，保留最大的n - k个
+    //O(n log min(k, n - k))，不会像快速选择那样在坏输入上退化为O(n^2)
+    template <class RandomAccessIterator, class T, class Distance, class Compare>
+    void _nth_element(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last,
+                      T*, Distance*, Compare comp) {
+        if(nth == last) return;
+        Distance k = nth - first, n = last - first;
+        if(k < n - k) {
+            make_heap<2>(first, nth + 1, comp);
+            for(RandomAccessIterator i = nth + 1; i < last; ++i)
+                if(comp(*i, *first))
+                    _pop_heap<2>(first, nth + 1, i, T(*i), (Distance*) 0, comp);
+            pop_heap<2>(first, nth + 1, comp); //堆顶即所求，换到nth处
+        }else {
+            _heap_reverse_compare<Compare> rcomp(comp);
+            make_heap<2>(nth, last, rcomp);
+            for(RandomAccessIterator i = first; i < nth; ++i)
+                if(comp(*nth, *i))
+                    _pop_heap<2>(nth, last, i, T(*i), (Distance*) 0, rcomp);
+            //堆顶已在nth处
+        }
+    }
+    template <class RandomAccessIterator, class T, class Distance>
+    inline void _nth_element(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last,
+                             T*, Distance*) {
+        _nth_element(first, nth, last, (T*) 0, (Distance*) 0, less<T>());
+    }
+    template <class RandomAccessIterator, class Compare>
+    inline void nth_element(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last,
+                            Compare comp) {
+        _nth_element(first, nth, last, value_type(first), distance_type(first), comp);
+    }
+    template <class RandomAccessIterator>
+    inline void nth_element(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last) {
+        _nth_element(first, nth, last, value_type(first), distance_type(first));
     }
 }
 #endif //MY_STL_HEAP_H
@@ -0,0 +1,188 @@
+#ifndef MY_STL_INTRUSIVE_LIST_H
+#define MY_STL_INTRUSIVE_LIST_H
+//侵入式双向链表：prev/next(钩子)嵌在元素自身中，插入删除不配置任何内存
+//list只链接对象，不拥有对象；对象的生命期由使用者(例如对象池)管理
+//钩子知道自己的前后节点，所以可以在不知道所属list的情况下O(1)摘除；也因此不维护元素个数，size()为O(n)
+#include <cstddef>
+#include "iterator.h"
+#include "list.h"
+namespace my_stl{
+    //钩子，未链接时prev/next为0；钩子析构时自动从链表摘除
+    struct intrusive_list_hook : public _list_node_base {
+        intrusive_list_hook() { prev = next = 0; }
+        //复制对象不复制链接关系
+        intrusive_list_hook(const intrusive_list_hook&) : _list_node_base() { prev = next = 0; }
+        intrusive_list_hook& operator= (const intrusive_list_hook&) { return *this; }
+        ~intrusive_list_hook() { unlink(); }
+        bool is_linked() const { return next != 0; }
+        //从所在的链表中摘除，未链接时什么也不做
+        void unlink() {
+            if(next) {
+                prev->next = next;
+                next->prev = prev;
+                prev = next = 0;
+            }
+        }
+    };
+
+    //钩子在元素中的位置：T公有继承intrusive_list_hook
+    template <class T>
+    struct intrusive_base_hook {
+        static intrusive_list_hook* to_hook(T* p) { return p; }
+        static T* to_value(_list_node_base* h) { return static_cast<T*>(static_cast<intrusive_list_hook*>(h)); }
+    };
+    //钩子在元素中的位置：T的数据成员Member；一个对象可以借不同成员同时挂在多个链表上
+    template <class T, intrusive_list_hook T::* Member>
+    struct intrusive_member_hook {
+        static intrusive_list_hook* to_hook(T* p) { return &(p->*Member); }
+        static T* to_value(_list_node_base* h) {
+            return reinterpret_cast<T*>(reinterpret_cast<char*>(h) - offset());
+        }
+        static ptrdiff_t offset() {
+            //借一块未构造的存储计算成员偏移，编译期即可折叠为常数
+            alignas(T) char probe[sizeof(T)];
+            T* t = reinterpret_cast<T*>(probe);
+            return reinterpret_cast<char*>(&(t->*Member)) - probe;
+        }
+    };
+
+    template <class T, class Ref, class Ptr, class Hook>
+    struct _intrusive_list_iterator {
+        typedef _intrusive_list_iterator<T, T&, T*, Hook> iterator;
+        typedef _intrusive_list_iterator<T, Ref, Ptr, Hook> self;
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _list_node_base* base_ptr;
+
+        base_ptr node;
+
+        _intrusive_list_iterator(base_ptr x) : node(x) {}
+        _intrusive_list_iterator() {}
+        _intrusive_list_iterator(const iterator& x) : node(x.node) {}
+
+        bool operator== (const self& x) const { return node == x.node; }
+        bool operator!= (const self& x) const { return node != x.node; }
+        reference operator*() const { return *Hook::to_value(node); }
+        pointer operator->() const { return &(operator*()); }
+        self& operator++() {
+            node = node->next;
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--() {
+            node = node->prev;
+            return *this;
+        }
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+    };
+
+    template <class T, class Hook = intrusive_base_hook<T> >
+    class intrusive_list {
+    public:
+        typedef T value_type;
+        typedef value_type& reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _intrusive_list_iterator<T, T&, T*, Hook> iterator;
+        typedef _intrusive_list_iterator<T, const T&, const T*, Hook> const_iterator;
+    protected:
+        typedef _list_node_base* base_ptr;
+        _list_node_base node; //哨兵
+
+        void empty_initialize() {
+            node.next = &node;
+            node.prev = &node;
+        }
+        static void reset(base_ptr p) { p->prev = p->next = 0; }
+    private:
+        intrusive_list(const intrusive_list&);
+        intrusive_list& operator= (const intrusive_list&);
+    public:
+        intrusive_list() { empty_initialize(); }
+        //析构时摘除所有元素，但不销毁它们
+        ~intrusive_list() { clear(); }
+
+        iterator begin() { return node.next; }
+        iterator end() { return &node; }
+        const_iterator begin() const { return node.next; }
+        const_iterator end() const { return const_cast<base_ptr>(&node); }
+        bool empty() const { return node.next == &node; }
+        //O(n)
+        size_type size() const { return size_type(distance(begin(), end())); }
+        reference front() { return *begin(); }
+        reference back() { return *(--end()); }
+        //由元素得到迭代器，O(1)
+        static iterator iterator_to(T& x) { return Hook::to_hook(&x); }
+
+        //x不能已经在某个链表中
+        iterator insert(iterator position, T& x) {
+            base_ptr h = Hook::to_hook(&x);
+            h->next = position.node;
+            h->prev = position.node->prev;
+            position.node->prev->next = h;
+            position.node->prev = h;
+            return h;
+        }
+        void push_front(T& x) { insert(begin(), x); }
+        void push_back(T& x) { insert(end(), x); }
+        iterator erase(iterator position) {
+            base_ptr next_node = position.node->next;
+            static_cast<intrusive_list_hook*>(position.node)->unlink();
+            return next_node;
+        }
+        void remove(T& x) { Hook::to_hook(&x)->unlink(); }
+        void pop_front() { erase(begin()); }
+        void pop_back() { erase(--end()); }
+        void clear() {
+            base_ptr cur = node.next;
+            while(cur != &node) {
+                base_ptr next = cur->next;
+                reset(cur);
+                cur = next;
+            }
+            empty_initialize();
+        }
+        //x必须不同于*this
+        void splice(iterator position, intrusive_list& x) {
+            if(!x.empty())
+                _list_transfer(position.node, x.node.next, &x.node);
+        }
+        //将i所指元素接合于position所指位置之前,position和i可指向同一个list
+        void splice(iterator position, intrusive_list&, iterator i) {
+            iterator j = i;
+            ++j;
+            if(position == i || position == j) return;
+            _list_transfer(position.node, i.node, j.node);
+        }
+        //将[first，last)内的所有元素移到position之前,position和该区间可位于同一list，但不能重合
+        void splice(iterator position, intrusive_list&, iterator first, iterator last) {
+            if(first != last)
+                _list_transfer(position.node, first.node, last.node);
+        }
+        //把元素移到表头/表尾，LRU维护常用
+        void move_to_front(T& x) { splice(begin(), *this, iterator_to(x)); }
+        void move_to_back(T& x) { splice(end(), *this, iterator_to(x)); }
+        void swap(intrusive_list& x) {
+            _list_node_base tmp = node;
+            node = x.node;
+            x.node = tmp;
+            if(node.next == &x.node) empty_initialize();
+            else node.next->prev = node.prev->next = &node;
+            if(x.node.next == &node) x.empty_initialize();
+            else x.node.next->prev = x.node.prev->next = &x.node;
+        }
+    };
+}
+#endif //MY_STL_INTRUSIVE_LIST_H
@@ -5,43 +5,59 @@
 #include "cons.h"
 #include "unin.h"
 namespace my_stl{
+    //只含链接的节点基类，list的哨兵节点只需要这一部分
+    struct _list_node_base{
+        typedef _list_node_base* base_ptr;
+        base_ptr prev;
+        base_ptr next;
+    };
     template <class T>
-    struct _list_node{
+    struct _list_node : public _list_node_base{
         T data;
-        typedef void* void_pointer;
-        void_pointer prev;
-        void_pointer next;
     };
+    //将[first，last)内的所有节点移到position之前，list与intrusive_list共用
+    inline void _list_transfer(_list_node_base* position, _list_node_base* first, _list_node_base* last) {
+        if(position != last){
+            last->prev->next = position;
+            first->prev->next = last;
+            position->prev->next = first;
+            _list_node_base* tmp = position->prev;
+            position->prev = last->prev;
+            last->prev = first->prev;
+            first->prev = tmp;
+        }
+    }
     //迭代器
     template <class T, class Ref, class Ptr>
     struct _list_iterator {
         typedef _list_iterator<T, T&, T*> iterator;
         typedef _list_iterator<T, Ref, Ptr> self;
-        typedef bidirectional_iterator_tag iterator_catrgory;
+        typedef bidirectional_iterator_tag iterator_category;
         typedef T value_type;
         typedef Ptr pointer;
         typedef Ref reference;
+        typedef _list_node_base* base_ptr;
         typedef _list_node<T>* link_type;
         typedef size_t size_type;
         typedef ptrdiff_t difference_type;
 
-        link_type node; //指向list的节点
+        base_ptr node; //指向list的节点，end()指向哨兵
 
         //constructor
-        _list_iterator(link_type x) :node(x) {}
+        _list_iterator(base_ptr x) :node(x) {}
         _list_iterator() {}
         _list_iterator(const iterator& x) : node(x.node) {}
 
-        bool operator== (const self& x) const { return node == x.node }
-        bool operator!= (const self& x) const { return node != x.node }
+        bool operator== (const self& x) const { return node == x.node; }
+        bool operator!= (const self& x) const { return node != x.node; }
         //取节点的值
-        reference operator*() const { return (*node).data; }
+        reference operator*() const { return ((link_type) node)->data; }
 
         //对迭代器的成员存取（member access）运算子的标准做法
         pointer operator->() const { return &(operator*()); }
         //递增
         self& operator++() {
-            node = (link_type) ((*node).next);
+            node = node->next;
             return *this;
         }
         self operator++(int) {
@@ -51,7 +67,7 @@ namespace my_stl{
         }
         //递减
         self& operator--() {
-            node = (link_type) ((*node).prev);
+            node = node->prev;
             return *this;
         }
         self operator--(int) {
@@ -60,29 +76,173 @@ namespace my_stl{
             return tmp;
         }
     };
-    template <class T, class Alloc = alloc>
-    class list {
+    //默认节点池：每次从Alloc配置一个节点，无状态
+    template <class T, class Alloc>
+    class _list_default_pool {
     protected:
         typedef _list_node<T> list_node;
         typedef my_alloc<list_node, Alloc> list_node_allocator; //专属空间配置器，每次配置一个节点
+    public:
+        //节点可以在使用该池的list之间自由移动(splice/merge)
+        static const bool shares_nodes = true;
+        list_node* allocate_node() { return list_node_allocator::allocate(); }
+        void deallocate_node(list_node* p) { list_node_allocator::deallocate(p); }
+        void swap(_list_default_pool&) {}
+    };
+
+    //每个list私有的slab节点池：节点从连续的大块(slab)中依次切出，释放的节点挂在池内的free list上
+    //相邻插入的节点在内存中也相邻；配合list::compact()可以按链表顺序重新排布所有节点
+    //节点归属于某个list的池，因此不能直接在list之间移动，splice/merge会先把节点复制到目标list的池中
+    template <class T, class Alloc = alloc>
+    class list_slab_pool {
+    protected:
+        typedef _list_node<T> list_node;
+        typedef my_alloc<char, Alloc> byte_allocator;
+        enum { _initial_slab_nodes = 32 };
+        enum { _max_slab_nodes = 4096 };
+        struct slab {
+            slab* next;
+            size_t nodes;
+        };
+        //slab头之后按节点对齐
+        static size_t header_bytes() {
+            return (sizeof(slab) + alignof(list_node) - 1) / alignof(list_node) * alignof(list_node);
+        }
+        static size_t slab_bytes(size_t n) {
+            return header_bytes() + n * sizeof(list_node);
+        }
+
+        slab* slabs;
+        _list_node_base* free_list;  //复用节点的next作为链接
+        list_node* bump;             //当前slab中尚未切出的部分
+        list_node* bump_end;
+        size_t next_slab_nodes;
+
+        void add_slab(size_t n) {
+            slab* s = (slab*) byte_allocator::allocate(slab_bytes(n));
+            s->next = slabs;
+            s->nodes = n;
+            slabs = s;
+            bump = (list_node*) ((char*) s + header_bytes());
+            bump_end = bump + n;
+        }
+        static void free_slabs(slab* s) {
+            while(s) {
+                slab* next = s->next;
+                byte_allocator::deallocate((char*) s, slab_bytes(s->nodes));
+                s = next;
+            }
+        }
+    private:
+        list_slab_pool(const list_slab_pool&);
+        list_slab_pool& operator= (const list_slab_pool&);
+    public:
+        static const bool shares_nodes = false;
+        //compact()期间暂存旧slab
+        typedef slab* slab_set;
+
+        list_slab_pool() : slabs(0), free_list(0), bump(0), bump_end(0), next_slab_nodes(_initial_slab_nodes) {}
+        ~list_slab_pool() { free_slabs(slabs); }
+
+        list_node* allocate_node() {
+            if(free_list) {
+                list_node* p = (list_node*) free_list;
+                free_list = free_list->next;
+                return p;
+            }
+            if(bump == bump_end) {
+                add_slab(next_slab_nodes);
+                if(next_slab_nodes < _max_slab_nodes)
+                    next_slab_nodes *= 2;
+            }
+            return bump++;
+        }
+        void deallocate_node(list_node* p) {
+            p->next = free_list;
+            free_list = p;
+        }
+        void swap(list_slab_pool& x) {
+            slab* s = slabs; slabs = x.slabs; x.slabs = s;
+            _list_node_base* f = free_list; free_list = x.free_list; x.free_list = f;
+            list_node* b = bump; bump = x.bump; x.bump = b;
+            b = bump_end; bump_end = x.bump_end; x.bump_end = b;
+            size_t n = next_slab_nodes; next_slab_nodes = x.next_slab_nodes; x.next_slab_nodes = n;
+        }
+        //取走全部slab，另配一块恰好n个节点的slab，接下来的n个节点从中连续切出
+        //这块slab是一次性的，不影响之后slab的增长；配置失败时池保持原状
+        slab_set detach(size_t n) {
+            slab* old = slabs;
+            _list_node_base* f = free_list;
+            list_node* b = bump;
+            list_node* e = bump_end;
+            slabs = 0;
+            free_list = 0;
+            bump = bump_end = 0;
+            if(n != 0) {
+                try {
+                    add_slab(n);
+                }
+                catch(...) {
+                    slabs = old;
+                    free_list = f;
+                    bump = b;
+                    bump_end = e;
+                    throw;
+                }
+            }
+            return old;
+        }
+        //释放detach()取走的slab
+        void release(slab_set old) { free_slabs(old); }
+        //搬迁失败时把旧slab收回，随池一起释放
+        void absorb(slab_set old) {
+            while(old) {
+                slab* next = old->next;
+                old->next = slabs;
+                slabs = old;
+                old = next;
+            }
+        }
+    };
+
+    template <class T, class Alloc = alloc, class NodePool = _list_default_pool<T, Alloc> >
+    class list : protected NodePool { //继承而非成员，默认的无状态节点池不占空间
+    protected:
+        typedef _list_node<T> list_node;
+        typedef _list_node_base* base_ptr;
+        typedef my_alloc<_list_node_base*, Alloc> ptr_allocator; //sort时收集节点指针用
+        //元素数不小于此值时sort()走收集-排序-重链的路径
+        enum { _relink_sort_threshold = 64 };
+        //数组排序时先用插入排序处理的小段长度
+        enum { _relink_sort_run = 16 };
     public:
         typedef list_node* link_type;
         typedef T value_type;
         typedef value_type& reference;
+        typedef const value_type& const_reference;
         typedef size_t size_type;
         typedef ptrdiff_t difference_type;
         typedef _list_iterator<T, T&, T*> iterator;
+        typedef _list_iterator<T, const T&, const T*> const_iterator;
     protected:
-        link_type node; //让node指向刻意置于尾端的一个空白节点
+        //哨兵节点直接嵌在list对象中，构造空list、sort用的临时list都不需要配置内存
+        _list_node_base node;
+        size_type length; //元素个数，size()为O(1)
         //配置一个节点并返回
-        link_type get_node() { return list_node_allocator::allocate(); }
+        link_type get_node() { return NodePool::allocate_node(); }
         //释放一个节点
-        void put_node(link_type p) { list_node_allocator::deallocate(p); }
+        void put_node(link_type p) { NodePool::deallocate_node(p); }
 
         //产生一个节点，带有元素值
         link_type create_node(const T& x) {
             link_type p = get_node();
-            construct(&p->data, x);
+            try {
+                construct(&p->data, x);
+            }
+            catch(...) {
+                put_node(p);
+                throw;
+            }
             return p;
         }
         //销毁一个节点
@@ -91,38 +251,61 @@ namespace my_stl{
             put_node(p);
         }
         void empty_initialize() {
-            node = get_node();
-            node->next = node;
-            node->prev = node;
+            node.next = &node;
+            node.prev = &node;
+            length = 0;
+        }
+        //哨兵的地址随list对象而定，交换内容后要让首尾节点重新指回各自的哨兵
+        static void fix_sentinel(_list_node_base& s, base_ptr old_sentinel) {
+            if(s.next == old_sentinel) {
+                s.next = &s;
+                s.prev = &s;
+            }else {
+                s.next->prev = &s;
+                s.prev->next = &s;
+            }
         }
     public:
         list() { empty_initialize(); } //产生一个空链表
-        iterator begin() { return (link_type)((*node).next); }
-        iterator end() { return node; }
-        bool empty() { return node->next == node; }
-        size_type size() const {
-            size_type result = 0;
-            distance(begin(), end(), result);
-            return result;
+        list(const list& x) {
+            empty_initialize();
+            for(const_iterator it = x.begin(); it != x.end(); ++it)
+                push_back(*it);
+        }
+        list& operator= (const list& x) {
+            if(this != &x) {
+                list tmp(x);
+                swap(tmp);
+            }
+            return *this;
         }
+        ~list() { clear(); }
+        iterator begin() { return node.next; }
+        iterator end() { return &node; }
+        const_iterator begin() const { return node.next; }
+        const_iterator end() const { return const_cast<base_ptr>(&node); }
+        bool empty() const { return node.next == &node; }
+        size_type size() const { return length; }
         reference front() { return *begin(); }
         reference back() { return *(--end()); }
         iterator insert(iterator position, const T& x) {
             link_type tmp = create_node(x);
             tmp->next = position.node;
             tmp->prev = position.node->prev;
-            (link_type(position.node->prev))->next = tmp;
+            position.node->prev->next = tmp;
             position.node->prev = tmp;
+            ++length;
             return tmp;
         }
         void push_front(const T& x) { insert(begin(), x); }
         void push_back(const T& x) { insert(end(), x); }
         iterator erase(iterator position) {
-            link_type next_node = link_type(position.node->next);
-            link_type prev_node = link_type(position.node->prev);
+            base_ptr next_node = position.node->next;
+            base_ptr prev_node = position.node->prev;
             prev_node->next = next_node;
             next_node->prev = prev_node;
-            destroy_node(position.node);
+            destroy_node((link_type) position.node);
+            --length;
             return iterator(next_node);
         }
         void pop_front() {
@@ -133,12 +316,13 @@ namespace my_stl{
             erase(--tmp);
         }
         void clear() {
-            link_type cur = begin();
-            while(cur != end()){
-                link_type tmp = cur;
-                cur = (link_type) cur->next;
-                destroy_node(tmp);
+            base_ptr cur = node.next;
+            while(cur != &node){
+                base_ptr tmp = cur;
+                cur = cur->next;
+                destroy_node((link_type) tmp);
             }
+            empty_initialize();
         }
         void remove(const T& value) { //移除所有值为value的元素
             iterator first = begin() ;
@@ -165,45 +349,81 @@ namespace my_stl{
             }
         }
     protected:
-        //将[first，last)内的所有元素移到position之前
-        void transfer(iterator position, iterator first, iterator last) {
-            if(position != last){
-                (*(link_type((*last.node).prev))).next = position.node;
-                (*(link_type((*first.node).prev))).next = last.node;
-                (*(link_type((*position.node).prev))).next = first.node;
-                link_type tmp = link_type((*position.node).prev);
-                (*position.node).prev = (*last.node).prev;
-                (*last.node).prev = (*first.node).prev;
-                (*first.node).prev = tmp;
+        //把x中[first, last)的节点原地换成本list节点池中的节点，返回新的first
+        //节点池不允许共享节点时，跨list的splice/merge之前调用
+        iterator adopt(list& x, iterator first, iterator last) {
+            if(NodePool::shares_nodes || &x == this || first == last)
+                return first;
+            base_ptr cur = first.node;
+            base_ptr new_first = 0;
+            while(cur != last.node) {
+                base_ptr next = cur->next;
+                link_type p = create_node(((link_type) cur)->data);
+                p->prev = cur->prev;
+                p->next = next;
+                cur->prev->next = p;
+                next->prev = p;
+                x.destroy_node((link_type) cur);
+                if(new_first == 0) new_first = p;
+                cur = next;
             }
+            return new_first;
+        }
+        //将[first，last)内的所有元素移到position之前，不维护length
+        void transfer(iterator position, iterator first, iterator last) {
+            _list_transfer(position.node, first.node, last.node);
         }
 
     public:
         //x必须不同于*this
         void splice(iterator postion, list& x) {
-            if(!x.empty())
-                transfer(postion, x.begin(), x.end());
+            if(!x.empty()) {
+                transfer(postion, adopt(x, x.begin(), x.end()), x.end());
+                length += x.length;
+                x.length = 0;
+            }
         }
         //将i所指元素接合于position所指位置之前,position和i可指向同一个list
-        void splice(iterator position, list&, iterator i) {
+        void splice(iterator position, list& x, iterator i) {
             iterator j = i;
             ++j;
             if(position == i || position == j) return;
-            transfer(position, i, j);
+            splice_node(position, x, adopt(x, i, j));
         }
         //将[first，last)内的所有元素移到position之前,position和该区间可位于同一list，但不能重合
-        void splice(iterator position, list&, iterator first, iterator last) {
-            if(first != last)
+        //来自另一个list时需要数一遍区间长度
+        void splice(iterator position, list& x, iterator first, iterator last) {
+            if(first != last) {
+                if(&x != this) {
+                    size_type n = distance(first, last);
+                    length += n;
+                    x.length -= n;
+                    first = adopt(x, first, last);
+                }
                 transfer(position, first, last);
+            }
         }
         //merge()将x合并在*this上，必须是单调不减的
-        void merge(list<T, Alloc>& x) {
+        void merge(list& x) {
+            adopt(x, x.begin(), x.end());
+            merge_nodes(x);
+        }
+    protected:
+        //不经adopt()的splice单个节点和merge，sort的临时list用；节点最终都回到*this
+        void splice_node(iterator position, list& x, iterator i) {
+            iterator j = i;
+            ++j;
+            transfer(position, i, j);
+            ++length;
+            --x.length;
+        }
+        void merge_nodes(list& x) {
             iterator first1 = begin();
             iterator last1 = end();
             iterator first2 = x.begin();
             iterator last2 = x.end();
-            while(first1! = last1 && first2 != last2){
-                if(*first1 < *first2) {
+            while(first1 != last1 && first2 != last2){
+                if(*first2 < *first1) {
                     iterator next = first2;
                     transfer(first1, first2, ++next);
                     first2 = next;
@@ -213,10 +433,13 @@ namespace my_stl{
             }
             if(first2 != last2)
                 transfer(last1, first2, last2);
+            length += x.length;
+            x.length = 0;
         }
+    public:
         //逆置
         void reverse() {
-            if(node->next == node || link_type(node->next)->next == node) return;
+            if(node.next == &node || node.next->next == &node) return;
             iterator first = begin();
             ++first;
             while(first != end()){
@@ -225,30 +448,153 @@ namespace my_stl{
                 transfer(begin(), old, first);
             }
         }
-        void swap(list<T, Alloc>& x) {
-            my_stl::swap(node, x.node);
+        void swap(list& x) {
+            NodePool::swap(x);
+            swap_nodes(x);
         }
-        //list 不能直接用STL的sort()
-        void sort() {
-            if(node->next == node || link_type(node->next)->next == node) return;
-            //中介数据存放区
-            list<T, Alloc> carry;
-            list<T, Alloc> counter[64];
+    protected:
+        //只交换链表内容，不交换节点池；sort的临时list用
+        void swap_nodes(list& x) {
+            _list_node_base tmp = node;
+            node = x.node;
+            x.node = tmp;
+            fix_sentinel(node, &x.node);
+            fix_sentinel(x.node, &node);
+            size_type n = length;
+            length = x.length;
+            x.length = n;
+        }
+        static bool less_node(base_ptr a, base_ptr b) {
+            return ((link_type) a)->data < ((link_type) b)->data;
+        }
+        //把[first, mid)和[mid, last)两段归并到result，相等时取左段，保持稳定
+        static void merge_ptrs(base_ptr* first, base_ptr* mid, base_ptr* last, base_ptr* result) {
+            base_ptr* i = first;
+            base_ptr* j = mid;
+            while(i != mid && j != last) {
+                if(less_node(*j, *i))
+                    *result++ = *j++;
+                else
+                    *result++ = *i++;
+            }
+            while(i != mid) *result++ = *i++;
+            while(j != last) *result++ = *j++;
+        }
+        //对节点指针数组做稳定的自底向上归并排序，buf与a等长，结果留在a中
+        static void sort_ptrs(base_ptr* a, base_ptr* buf, size_type n) {
+            //小段插入排序
+            for(size_type lo = 0; lo < n; lo += _relink_sort_run) {
+                size_type hi = lo + _relink_sort_run < n ? lo + _relink_sort_run : n;
+                for(size_type i = lo + 1; i < hi; ++i) {
+                    base_ptr x = a[i];
+                    size_type j = i;
+                    for(; j > lo && less_node(x, a[j - 1]); --j)
+                        a[j] = a[j - 1];
+                    a[j] = x;
+                }
+            }
+            //在a与buf之间来回归并
+            base_ptr* from = a;
+            base_ptr* to = buf;
+            for(size_type width = _relink_sort_run; width < n; width *= 2) {
+                for(size_type lo = 0; lo < n; lo += 2 * width) {
+                    size_type mid = lo + width < n ? lo + width : n;
+                    size_type hi = lo + 2 * width < n ? lo + 2 * width : n;
+                    merge_ptrs(from + lo, from + mid, from + hi, to + lo);
+                }
+                base_ptr* tmp = from;
+                from = to;
+                to = tmp;
+            }
+            if(from != a) {
+                for(size_type i = 0; i != n; ++i)
+                    a[i] = from[i];
+            }
+        }
+        //把节点指针收集到连续数组中排序，再一次性重建prev/next
+        //比较时只访问数组和节点数据，避免在链表上逐个追指针；返回false表示内存不足
+        bool relink_sort() {
+            size_type n = length;
+            base_ptr* a;
+            base_ptr* buf;
+            try {
+                a = ptr_allocator::allocate(2 * n);
+            }
+            catch(...) {
+                return false;
+            }
+            buf = a + n;
+            base_ptr cur = node.next;
+            for(size_type i = 0; i != n; ++i, cur = cur->next)
+                a[i] = cur;
+            sort_ptrs(a, buf, n);
+            base_ptr prev = &node;
+            for(size_type i = 0; i != n; ++i) {
+                a[i]->prev = prev;
+                prev->next = a[i];
+                prev = a[i];
+            }
+            prev->next = &node;
+            node.prev = prev;
+            ptr_allocator::deallocate(a, 2 * n);
+            return true;
+        }
+        //原有的链表归并排序，只用splice/merge，不需要额外内存
+        void merge_sort() {
+            //中介数据存放区，哨兵内嵌，不配置内存
+            list carry;
+            list counter[64];
             int fill = 0;
             while(!empty()) {
-                carry.splice(carry.begin(), *this, begin());
+                carry.splice_node(carry.begin(), *this, begin());
                 int i = 0;
                 while(i < fill && !counter[i].empty()){
-                    counter[i].merge(carry);
-                    carry.swap(counter[i++]);
+                    counter[i].merge_nodes(carry);
+                    carry.swap_nodes(counter[i++]);
                 }
-                carry.swap(counter[i]);
+                carry.swap_nodes(counter[i]);
                 if(i == fill) ++fill;
             }
             for(int i = 1; i < fill; ++i)
-                counter[i].merge(counter[i-1]);
-            swap(counter[fill-1]);
+                counter[i].merge_nodes(counter[i-1]);
+            swap_nodes(counter[fill-1]);
+        }
+    public:
+        //list 不能直接用STL的sort()；稳定排序
+        void sort() {
+            if(node.next == &node || node.next->next == &node) return;
+            if(length >= _relink_sort_threshold && relink_sort())
+                return;
+            merge_sort();
+        }
+        //按链表顺序把所有节点搬到新的连续slab中，恢复顺序遍历的局部性；只对list_slab_pool有效
+        //元素逐个复制构造；若中途抛出异常，list仍然完整，旧slab留在池中
+        void compact() {
+            typename NodePool::slab_set old = NodePool::detach(length);
+            base_ptr cur = node.next;
+            try {
+                while(cur != &node) {
+                    base_ptr next = cur->next;
+                    link_type p = create_node(((link_type) cur)->data);
+                    p->prev = cur->prev;
+                    p->next = next;
+                    cur->prev->next = p;
+                    next->prev = p;
+                    destroy(&((link_type) cur)->data); //旧节点的内存随旧slab一起释放
+                    cur = next;
+                }
+            }
+            catch(...) {
+                NodePool::absorb(old);
+                throw;
+            }
+            NodePool::release(old);
         }
     };
+#if __cplusplus >= 201103L
+    //节点取自每个list私有slab的list
+    template <class T, class Alloc = alloc>
+    using slab_list = list<T, Alloc, list_slab_pool<T, Alloc> >;
+#endif
 }
 #endif //MY_STL_LIST_H
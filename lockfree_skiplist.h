@@ -0,0 +1,284 @@
+#ifndef MY_STL_LOCKFREE_SKIPLIST_H
+#define MY_STL_LOCKFREE_SKIPLIST_H
+//无锁跳表：键值唯一的有序映射，多个线程可以同时插入、删除、查找和按区间遍历
+//每层的next指针最低位是删除标记：删除时自上而下给各层打标记，第0层标记成功即为删除成功，随后由查找顺路把节点摘下
+//节点摘下后经epoch_retire延迟释放；迭代器、lower_bound的结果只在调用者持有的epoch_guard内有效
+//插入者可能在节点被标记后才链好上层，所以节点要等插入者和删除者都放手之后才登记回收
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "iterator.h"
+#include "mt_alloc.h"
+#include "cons.h"
+#include "epoch.h"
+#include "functional.h"
+#include "pair.h"
+namespace my_stl{
+    template <class Value>
+    struct _skiplist_node {
+        Value value;
+        int height;
+        std::atomic<int> refs;            //插入者和删除者各持有一份
+        std::atomic<uintptr_t> next[1];   //实际长度为height，最低位为删除标记
+
+        _skiplist_node* get_next(int i) const {
+            return reinterpret_cast<_skiplist_node*>(next[i].load(std::memory_order_acquire) & ~uintptr_t(1));
+        }
+        bool marked() const { return next[0].load(std::memory_order_acquire) & 1; }
+    };
+
+    //迭代器沿第0层前进，跳过已标记删除的节点
+    template <class Value>
+    struct _skiplist_iterator {
+        typedef _skiplist_iterator<Value> self;
+        typedef forward_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef const Value* pointer;
+        typedef const Value& reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _skiplist_node<Value>* link_type;
+
+        link_type node;
+
+        _skiplist_iterator() {}
+        explicit _skiplist_iterator(link_type x) : node(x) { skip_marked(); }
+
+        void skip_marked() {
+            while(node && node->marked())
+                node = node->get_next(0);
+        }
+        bool operator== (const self& x) const { return node == x.node; }
+        bool operator!= (const self& x) const { return node != x.node; }
+        reference operator*() const { return node->value; }
+        pointer operator->() const { return &(operator*()); }
+        self& operator++() {
+            node = node->get_next(0);
+            skip_marked();
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+    };
+
+    template <class Key, class T, class Compare = less<Key>, class Alloc = mt_alloc>
+    class lockfree_skiplist {
+    public:
+        typedef Key key_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+        typedef Compare key_compare;
+        typedef size_t size_type;
+        //元素插入后不可修改，只有const迭代器
+        typedef _skiplist_iterator<value_type> iterator;
+        typedef _skiplist_iterator<value_type> const_iterator;
+    protected:
+        typedef _skiplist_node<value_type> node;
+        typedef node* link_type;
+        enum { _max_height = 32 };
+
+        link_type head; //哨兵，value不构造
+        std::atomic<size_t> count;
+        Compare comp;
+
+        static size_t node_bytes(int h) { return sizeof(node) + (h - 1) * sizeof(std::atomic<uintptr_t>); }
+        static link_type allocate_node(int h) {
+            link_type p = (link_type) Alloc::allocate(node_bytes(h));
+            p->height = h;
+            new(&p->refs) std::atomic<int>(2);
+            for(int i = 0; i != h; ++i)
+                new(&p->next[i]) std::atomic<uintptr_t>(0);
+            return p;
+        }
+        static void deallocate_node(link_type p) { Alloc::deallocate(p, node_bytes(p->height)); }
+        static void destroy_node(void* q) {
+            link_type p = (link_type) q;
+            destroy(&p->value);
+            deallocate_node(p);
+        }
+        //插入者或删除者放手；两者都放手后登记回收
+        static void release(link_type p) {
+            if(p->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                epoch_retire(p, &destroy_node);
+        }
+        //每层以1/2的概率升高
+        static int random_height() {
+            static thread_local uint32_t state = 0;
+            if(state == 0) state = uint32_t(uintptr_t(&state) >> 4) | 1;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            int h = 1;
+            for(uint32_t r = state; (r & 1) && h < _max_height; r >>= 1)
+                ++h;
+            return h;
+        }
+        static uintptr_t mark(uintptr_t p) { return p | 1; }
+        static bool is_marked(uintptr_t p) { return p & 1; }
+        static link_type ptr(uintptr_t p) { return reinterpret_cast<link_type>(p & ~uintptr_t(1)); }
+
+        //在每一层找到k的前驱与后继，顺路摘下已标记的节点；返回第0层的后继是否就是k
+        //不沿已标记的指针下行：被删节点冻结的next可能指向早已回收的节点，遇到时从头再找
+        bool find(const key_type& k, link_type* preds, link_type* succs) const {
+        retry:
+            link_type pred = head;
+            for(int i = _max_height - 1; i >= 0; --i) {
+                uintptr_t first = pred->next[i].load(std::memory_order_acquire);
+                if(is_marked(first)) goto retry;
+                link_type curr = ptr(first);
+                while(curr) {
+                    uintptr_t succ = curr->next[i].load(std::memory_order_acquire);
+                    while(is_marked(succ)) {
+                        uintptr_t expected = uintptr_t(curr);
+                        if(!pred->next[i].compare_exchange_strong(expected, uintptr_t(ptr(succ)), std::memory_order_acq_rel))
+                            goto retry;
+                        curr = ptr(succ);
+                        if(curr == 0) break;
+                        succ = curr->next[i].load(std::memory_order_acquire);
+                    }
+                    if(curr == 0 || !comp(curr->value.first, k)) break;
+                    pred = curr;
+                    curr = ptr(succ);
+                }
+                preds[i] = pred;
+                succs[i] = curr;
+            }
+            return succs[0] && !comp(k, succs[0]->value.first);
+        }
+        //第一个键值不小于k的节点
+        link_type lower_node(const key_type& k) const {
+            link_type preds[_max_height];
+            link_type succs[_max_height];
+            find(k, preds, succs);
+            return succs[0];
+        }
+    private:
+        lockfree_skiplist(const lockfree_skiplist&);
+        lockfree_skiplist& operator= (const lockfree_skiplist&);
+    public:
+        explicit lockfree_skiplist(const Compare& c = Compare()) : count(0), comp(c) {
+            head = allocate_node(_max_height);
+        }
+        //析构时已无并发访问，第0层上的节点都还未登记回收
+        ~lockfree_skiplist() {
+            link_type p = head->get_next(0);
+            while(p) {
+                link_type next = p->get_next(0);
+                destroy_node(p);
+                p = next;
+            }
+            deallocate_node(head);
+        }
+
+        key_compare key_comp() const { return comp; }
+        //并发时只是近似值
+        size_type size() const { return count.load(std::memory_order_relaxed); }
+        bool empty() const { return size() == 0; }
+        //以下返回迭代器的函数须在epoch_guard内调用，迭代器也只在其中有效
+        iterator begin() const { return iterator(head->get_next(0)); }
+        iterator end() const { return iterator(0); }
+        iterator lower_bound(const key_type& k) const { return iterator(lower_node(k)); }
+        iterator upper_bound(const key_type& k) const {
+            iterator it = lower_bound(k);
+            if(it != end() && !comp(k, it->first)) ++it;
+            return it;
+        }
+
+        bool find(const key_type& k, T& out) const {
+            epoch_guard g;
+            link_type p = lower_node(k);
+            if(p == 0 || comp(k, p->value.first)) return false;
+            out = p->value.second;
+            return true;
+        }
+        bool contains(const key_type& k) const {
+            epoch_guard g;
+            iterator it = lower_bound(k);
+            return it != end() && !comp(k, it->first);
+        }
+        //对[first, last)中的元素依次调用f(const value_type&)，与写操作并发时是弱一致的
+        template <class Function>
+        void for_range(const key_type& first, const key_type& last, Function f) const {
+            epoch_guard g;
+            for(iterator it = lower_bound(first); it != end() && comp(it->first, last); ++it)
+                f(*it);
+        }
+
+        //键值不存在时插入，返回是否插入
+        bool insert(const key_type& k, const T& v) {
+            epoch_guard g;
+            link_type preds[_max_height];
+            link_type succs[_max_height];
+            int h = random_height();
+            link_type p = allocate_node(h);
+            try {
+                construct(&p->value, value_type(k, v));
+            }
+            catch(...) {
+                deallocate_node(p);
+                throw;
+            }
+            for(;;) {
+                if(find(k, preds, succs)) {
+                    destroy_node(p); //尚未发布
+                    return false;
+                }
+                for(int i = 0; i != h; ++i)
+                    p->next[i].store(uintptr_t(succs[i]), std::memory_order_relaxed);
+                uintptr_t expected = uintptr_t(succs[0]);
+                if(preds[0]->next[0].compare_exchange_strong(expected, uintptr_t(p), std::memory_order_acq_rel))
+                    break;
+            }
+            count.fetch_add(1, std::memory_order_relaxed);
+            //自下而上链入各层；节点被标记后就不再链
+            for(int i = 1; i != h; ++i) {
+                for(;;) {
+                    uintptr_t cur = p->next[i].load(std::memory_order_acquire);
+                    if(is_marked(cur)) goto linked;
+                    if(ptr(cur) != succs[i] &&
+                       !p->next[i].compare_exchange_strong(cur, uintptr_t(succs[i]), std::memory_order_acq_rel))
+                        goto linked;
+                    uintptr_t expected = uintptr_t(succs[i]);
+                    if(preds[i]->next[i].compare_exchange_strong(expected, uintptr_t(p), std::memory_order_acq_rel))
+                        break;
+                    if(!find(k, preds, succs) || succs[0] != p) goto linked;
+                }
+            }
+        linked:
+            //与erase中的栅栏配对：要么删除者的查找看到了新链上的层，要么这里看到删除标记
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            //链入期间被删除了：再找一遍，摘掉可能在删除者摘除之后才链上的层
+            if(p->marked()) find(k, preds, succs);
+            release(p);
+            return true;
+        }
+        bool erase(const key_type& k) {
+            epoch_guard g;
+            link_type preds[_max_height];
+            link_type succs[_max_height];
+            if(!find(k, preds, succs)) return false;
+            link_type p = succs[0];
+            for(int i = p->height - 1; i > 0; --i) {
+                uintptr_t cur = p->next[i].load(std::memory_order_acquire);
+                while(!is_marked(cur) && !p->next[i].compare_exchange_weak(cur, mark(cur), std::memory_order_acq_rel))
+                    ;
+            }
+            uintptr_t cur = p->next[0].load(std::memory_order_acquire);
+            for(;;) {
+                if(is_marked(cur)) return false; //别的线程先删除了它
+                if(p->next[0].compare_exchange_weak(cur, mark(cur), std::memory_order_acq_rel))
+                    break;
+            }
+            count.fetch_sub(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            find(k, preds, succs);
+            release(p);
+            return true;
+        }
+    };
+}
+#endif //MY_STL_LOCKFREE_SKIPLIST_H
@@ -0,0 +1,81 @@
+#ifndef MY_STL_LOCKFREE_STACK_H
+#define MY_STL_LOCKFREE_STACK_H
+//Treiber无锁栈，用于跨线程共享的freelist、对象池
+//pop摘下的节点经epoch_retire延迟释放，在任何线程还可能读到它之前不会被释放或重用，因此没有ABA问题
+#include <atomic>
+#include <cstddef>
+#include "mt_alloc.h"
+#include "cons.h"
+#include "epoch.h"
+namespace my_stl{
+    template <class T>
+    struct _lockfree_stack_node {
+        T data;
+        _lockfree_stack_node* next;
+    };
+
+    template <class T, class Alloc = mt_alloc>
+    class lockfree_stack {
+    public:
+        typedef T value_type;
+        typedef size_t size_type;
+    protected:
+        typedef _lockfree_stack_node<T> stack_node;
+        typedef stack_node* link_type;
+        typedef my_alloc<stack_node, Alloc> node_allocator;
+
+        std::atomic<link_type> head;
+
+        static link_type create_node(const T& x) {
+            link_type p = node_allocator::allocate();
+            try {
+                construct(&p->data, x);
+            }
+            catch(...) {
+                node_allocator::deallocate(p);
+                throw;
+            }
+            return p;
+        }
+        static void destroy_node(void* p) {
+            link_type q = (link_type) p;
+            destroy(&q->data);
+            node_allocator::deallocate(q);
+        }
+    private:
+        lockfree_stack(const lockfree_stack&);
+        lockfree_stack& operator= (const lockfree_stack&);
+    public:
+        lockfree_stack() : head(0) {}
+        //析构时已无并发访问
+        ~lockfree_stack() {
+            link_type p = head.load(std::memory_order_relaxed);
+            while(p) {
+                link_type next = p->next;
+                destroy_node(p);
+                p = next;
+            }
+        }
+        //并发时只是瞬时快照
+        bool empty() const { return head.load(std::memory_order_acquire) == 0; }
+
+        void push(const value_type& x) {
+            link_type p = create_node(x);
+            p->next = head.load(std::memory_order_relaxed);
+            while(!head.compare_exchange_weak(p->next, p, std::memory_order_release, std::memory_order_relaxed))
+                ;
+        }
+        //栈空时返回false
+        bool pop(value_type& x) {
+            epoch_guard g; //保证读p->next时p尚未被释放
+            link_type p = head.load(std::memory_order_acquire);
+            while(p && !head.compare_exchange_weak(p, p->next, std::memory_order_acquire, std::memory_order_acquire))
+                ;
+            if(p == 0) return false;
+            x = p->data;
+            epoch_retire(p, &destroy_node);
+            return true;
+        }
+    };
+}
+#endif //MY_STL_LOCKFREE_STACK_H
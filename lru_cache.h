@@ -0,0 +1,299 @@
+#ifndef MY_STL_LRU_CACHE_H
+#define MY_STL_LRU_CACHE_H
+//LRU缓存：条目按最近使用的顺序串在list中(表头最新，表尾最旧)，另有一张散列索引由key找到节点
+//命中时用list的splice把节点移到表头，淘汰时摘除表尾，get/put/淘汰都是O(1)
+//条目放在slab节点池里，不为每个条目单独配置内存；散列桶直接链接list节点，不另配桶节点
+//容量按条目的权重计算：默认每个条目权重为1，即按个数限制；换一个Weigher即可按字节限制
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include "alloc.h"
+#include "mt_alloc.h"
+#include "list.h"
+#include "hash_fun.h"
+#include "functional.h"
+namespace my_stl{
+    template <class Key, class Value>
+    struct _lru_entry {
+        Key key;
+        Value value;
+        size_t hash_code;
+        size_t weight;
+        _list_node_base* hash_next; //同一个桶中的下一个节点
+    };
+
+    //每个条目权重为1，容量即条目个数
+    struct lru_count_weigher {
+        template <class Key, class Value>
+        size_t operator() (const Key&, const Value&) const { return 1; }
+    };
+    //按key与value本身的大小计，值中另有堆内存(例如字符串)时需要自行提供Weigher
+    struct lru_sizeof_weigher {
+        template <class Key, class Value>
+        size_t operator() (const Key&, const Value&) const { return sizeof(Key) + sizeof(Value); }
+    };
+
+    template <class Key, class Value, class Hash = hash<Key>, class EqualKey = equal_to<Key>,
+              class Weigher = lru_count_weigher, class Alloc = alloc>
+    class lru_cache {
+    public:
+        typedef Key key_type;
+        typedef Value mapped_type;
+        typedef _lru_entry<Key, Value> value_type;
+        typedef size_t size_type;
+        //淘汰回调，在条目销毁之前调用，可以把value移走
+        typedef void (*evict_callback)(const Key&, Value&, void*);
+    protected:
+        typedef list<value_type, Alloc, list_slab_pool<value_type, Alloc> > entry_list;
+        typedef typename entry_list::iterator list_iterator;
+        typedef _list_node_base* base_ptr;
+        typedef my_alloc<base_ptr, Alloc> bucket_allocator;
+        enum { _initial_buckets = 16 };
+    public:
+        //从最近使用到最久未使用遍历
+        typedef typename entry_list::const_iterator const_iterator;
+    protected:
+        entry_list entries;
+        base_ptr* buckets;
+        size_type num_buckets;  //2的幂
+        size_type bucket_shift;
+        size_type cap;
+        size_type total_weight;
+        Hash hasher;
+        EqualKey equals;
+        Weigher weigher;
+        evict_callback on_evict;
+        void* evict_arg;
+
+        static value_type& entry_of(base_ptr p) { return *list_iterator(p); }
+        //乘法散列取高位，整数key的散列值是其自身，直接取低位在步长为2的幂时会扎堆
+        size_type bucket_index(size_t h) const {
+            return size_type((h * size_t(0x9E3779B97F4A7C15ULL)) >> bucket_shift);
+        }
+        base_ptr find_node(const Key& k, size_t h) const {
+            for(base_ptr p = buckets[bucket_index(h)]; p; p = entry_of(p).hash_next) {
+                value_type& e = entry_of(p);
+                if(e.hash_code == h && equals(e.key, k))
+                    return p;
+            }
+            return 0;
+        }
+        void link_bucket(base_ptr p) {
+            value_type& e = entry_of(p);
+            base_ptr& head = buckets[bucket_index(e.hash_code)];
+            e.hash_next = head;
+            head = p;
+        }
+        void unlink_bucket(base_ptr p) {
+            base_ptr* link = &buckets[bucket_index(entry_of(p).hash_code)];
+            while(*link != p)
+                link = &entry_of(*link).hash_next;
+            *link = entry_of(p).hash_next;
+        }
+        void allocate_buckets(size_type n) {
+            buckets = bucket_allocator::allocate(n);
+            for(size_type i = 0; i != n; ++i)
+                buckets[i] = 0;
+            num_buckets = n;
+            size_type bits = 0;
+            while((size_type(1) << bits) < n)
+                ++bits;
+            bucket_shift = sizeof(size_t) * 8 - bits;
+        }
+        //桶数翻倍，沿list重新挂一遍所有节点
+        void rehash(size_type n) {
+            base_ptr* old = buckets;
+            size_type old_n = num_buckets;
+            allocate_buckets(n);
+            for(list_iterator it = entries.begin(); it != entries.end(); ++it)
+                link_bucket(it.node);
+            bucket_allocator::deallocate(old, old_n);
+        }
+        void move_to_front(base_ptr p) {
+            entries.splice(entries.begin(), entries, list_iterator(p));
+        }
+        void erase_node(base_ptr p) {
+            unlink_bucket(p);
+            total_weight -= entry_of(p).weight;
+            entries.erase(list_iterator(p));
+        }
+        //从表尾淘汰，直到总权重不超过limit
+        void evict_to(size_type limit) {
+            while(total_weight > limit && !entries.empty()) {
+                base_ptr p = entries.end().node->prev;
+                if(on_evict) {
+                    value_type& e = entry_of(p);
+                    on_evict(e.key, e.value, evict_arg);
+                }
+                erase_node(p);
+            }
+        }
+    private:
+        lru_cache(const lru_cache&);
+        lru_cache& operator= (const lru_cache&);
+    public:
+        explicit lru_cache(size_type capacity, const Weigher& w = Weigher(),
+                           const Hash& hf = Hash(), const EqualKey& eql = EqualKey())
+            : cap(capacity), total_weight(0), hasher(hf), equals(eql), weigher(w),
+              on_evict(0), evict_arg(0) {
+            allocate_buckets(_initial_buckets);
+        }
+        ~lru_cache() { bucket_allocator::deallocate(buckets, num_buckets); }
+
+        const_iterator begin() const { return entries.begin(); }
+        const_iterator end() const { return entries.end(); }
+        size_type size() const { return entries.size(); }
+        bool empty() const { return entries.empty(); }
+        size_type capacity() const { return cap; }
+        //当前所有条目的权重之和
+        size_type weight() const { return total_weight; }
+
+        void set_evict_callback(evict_callback fn, void* arg = 0) {
+            on_evict = fn;
+            evict_arg = arg;
+        }
+        //缩小容量时立即淘汰
+        void set_capacity(size_type capacity) {
+            cap = capacity;
+            evict_to(cap);
+        }
+
+        //命中时标记为最近使用并返回值的地址，未命中返回0；地址在该条目被淘汰或删除前有效
+        Value* get(const Key& k) {
+            base_ptr p = find_node(k, hasher(k));
+            if(!p) return 0;
+            move_to_front(p);
+            return &entry_of(p).value;
+        }
+        //只查找，不改变使用顺序
+        Value* peek(const Key& k) {
+            base_ptr p = find_node(k, hasher(k));
+            return p ? &entry_of(p).value : 0;
+        }
+        bool contains(const Key& k) const { return find_node(k, hasher(k)) != 0; }
+        //插入或更新，并标记为最近使用；超出容量时从最久未使用的条目开始淘汰
+        //单个条目的权重超过容量时，它自己也会被淘汰
+        void put(const Key& k, const Value& v) {
+            size_t h = hasher(k);
+            size_type w = weigher(k, v);
+            base_ptr p = find_node(k, h);
+            if(p) {
+                value_type& e = entry_of(p);
+                e.value = v;
+                total_weight = total_weight - e.weight + w;
+                e.weight = w;
+                move_to_front(p);
+            }else {
+                if(entries.size() >= num_buckets)
+                    rehash(num_buckets * 2);
+                value_type e = { k, v, h, w, 0 };
+                entries.push_front(e);
+                link_bucket(entries.begin().node);
+                total_weight += w;
+            }
+            evict_to(cap);
+        }
+        //删除不触发淘汰回调
+        bool erase(const Key& k) {
+            base_ptr p = find_node(k, hasher(k));
+            if(!p) return false;
+            erase_node(p);
+            return true;
+        }
+        void clear() {
+            entries.clear();
+            for(size_type i = 0; i != num_buckets; ++i)
+                buckets[i] = 0;
+            total_weight = 0;
+        }
+    };
+
+    //分片的LRU缓存：按key的散列值分到Shards个各自加锁的lru_cache上，不同分片的操作互不阻塞
+    //每个分片独立淘汰，容量平均分给各分片；alloc不是线程安全的，默认改用mt_alloc
+    template <class Key, class Value, class Hash = hash<Key>, class EqualKey = equal_to<Key>,
+              class Weigher = lru_count_weigher, class Alloc = mt_alloc, size_t Shards = 16>
+    class sharded_lru_cache {
+    public:
+        typedef Key key_type;
+        typedef Value mapped_type;
+        typedef size_t size_type;
+        typedef lru_cache<Key, Value, Hash, EqualKey, Weigher, Alloc> cache_type;
+        typedef typename cache_type::evict_callback evict_callback;
+    protected:
+        struct shard {
+            std::mutex m;
+            cache_type cache;
+            shard(size_type capacity, const Weigher& w, const Hash& hf, const EqualKey& eql)
+                : cache(capacity, w, hf, eql) {}
+        };
+        typedef my_alloc<shard, Alloc> shard_allocator;
+
+        shard* shards;
+        Hash hasher;
+
+        //散列值先乘以黄金分割常数再取高半部分：hash<整数>是恒等映射，直接对Shards取模时等间隔的key会挤在同一分片
+        shard& shard_of(const Key& k) {
+            size_t h = hasher(k) * size_t(0x9E3779B97F4A7C15ULL);
+            return shards[(h >> (sizeof(size_t) * 4)) % Shards];
+        }
+    private:
+        sharded_lru_cache(const sharded_lru_cache&);
+        sharded_lru_cache& operator= (const sharded_lru_cache&);
+    public:
+        explicit sharded_lru_cache(size_type capacity, const Weigher& w = Weigher(),
+                                   const Hash& hf = Hash(), const EqualKey& eql = EqualKey())
+            : shards(shard_allocator::allocate(Shards)), hasher(hf) {
+            size_type per_shard = (capacity + Shards - 1) / Shards;
+            for(size_t i = 0; i != Shards; ++i)
+                new (&shards[i]) shard(per_shard, w, hf, eql);
+        }
+        ~sharded_lru_cache() {
+            for(size_t i = 0; i != Shards; ++i)
+                shards[i].~shard();
+            shard_allocator::deallocate(shards, Shards);
+        }
+
+        //回调在分片的锁内调用，不能再访问本缓存
+        void set_evict_callback(evict_callback fn, void* arg = 0) {
+            for(size_t i = 0; i != Shards; ++i) {
+                std::lock_guard<std::mutex> g(shards[i].m);
+                shards[i].cache.set_evict_callback(fn, arg);
+            }
+        }
+        //命中时把值复制到out
+        bool get(const Key& k, Value& out) {
+            shard& s = shard_of(k);
+            std::lock_guard<std::mutex> g(s.m);
+            Value* v = s.cache.get(k);
+            if(!v) return false;
+            out = *v;
+            return true;
+        }
+        void put(const Key& k, const Value& v) {
+            shard& s = shard_of(k);
+            std::lock_guard<std::mutex> g(s.m);
+            s.cache.put(k, v);
+        }
+        bool erase(const Key& k) {
+            shard& s = shard_of(k);
+            std::lock_guard<std::mutex> g(s.m);
+            return s.cache.erase(k);
+        }
+        void clear() {
+            for(size_t i = 0; i != Shards; ++i) {
+                std::lock_guard<std::mutex> g(shards[i].m);
+                shards[i].cache.clear();
+            }
+        }
+        //并发时只是近似值
+        size_type size() {
+            size_type n = 0;
+            for(size_t i = 0; i != Shards; ++i) {
+                std::lock_guard<std::mutex> g(shards[i].m);
+                n += shards[i].cache.size();
+            }
+            return n;
+        }
+    };
+}
+#endif //MY_STL_LRU_CACHE_H
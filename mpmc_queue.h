@@ -0,0 +1,141 @@
+#ifndef MY_STL_MPMC_QUEUE_H
+#define MY_STL_MPMC_QUEUE_H
+//有界多生产者多消费者队列
+//环形缓冲区的每个槽带一个序号(sequence)，生产者/消费者各自用CAS抢占位置，快路径无锁
+//槽序号 == pos        可写
+//槽序号 == pos + 1    可读
+//槽序号 == pos + 容量 上一轮的数据已被取走，下一轮可写
+#include <atomic>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include "alloc.h"
+#include "cons.h"
+#include "wait_strategy.h"
+namespace my_stl{
+    enum { _cache_line_size = 64 };
+
+    template <class T, class WaitStrategy = yield_wait_strategy, class Alloc = malloc_alloc>
+    class mpmc_queue {
+    public:
+        typedef T value_type;
+        typedef size_t size_type;
+        typedef value_type& reference;
+    protected:
+        struct cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+        //第二级配置器alloc不讨论多线程，这里默认用第一级配置器
+        typedef my_alloc<cell, Alloc> cell_allocator;
+
+        cell* buffer;
+        size_type mask;  //容量-1，容量为2的幂
+        alignas(_cache_line_size) std::atomic<size_t> enqueue_pos;
+        alignas(_cache_line_size) std::atomic<size_t> dequeue_pos;
+        alignas(_cache_line_size) WaitStrategy not_empty; //消费者在空队列上等待
+        alignas(_cache_line_size) WaitStrategy not_full;  //生产者在满队列上等待
+
+        static size_type round_up_pow2(size_type n) {
+            size_type r = 2;
+            while(r < n) r <<= 1;
+            return r;
+        }
+    private:
+        mpmc_queue(const mpmc_queue&);
+        mpmc_queue& operator= (const mpmc_queue&);
+    public:
+        explicit mpmc_queue(size_type n) : enqueue_pos(0), dequeue_pos(0) {
+            size_type cap = round_up_pow2(n);
+            buffer = cell_allocator::allocate(cap);
+            mask = cap - 1;
+            for(size_type i = 0; i != cap; ++i)
+                new(&buffer[i].sequence) std::atomic<size_t>(i);
+        }
+        ~mpmc_queue() {
+            //析构时已无并发访问，逐个销毁剩余元素
+            size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            size_t end = enqueue_pos.load(std::memory_order_relaxed);
+            for(; pos != end; ++pos)
+                destroy(&buffer[pos & mask].data);
+            cell_allocator::deallocate(buffer, mask + 1);
+        }
+        size_type capacity() const { return mask + 1; }
+        //并发时只是近似值
+        size_type size() const {
+            size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+            size_t head = dequeue_pos.load(std::memory_order_relaxed);
+            return tail > head ? size_type(tail - head) : 0;
+        }
+        bool empty() const { return size() == 0; }
+
+        bool try_push(const value_type& x) {
+            cell* c;
+            size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            for(;;) {
+                c = &buffer[pos & mask];
+                size_t seq = c->sequence.load(std::memory_order_acquire);
+                intptr_t diff = intptr_t(seq) - intptr_t(pos);
+                if(diff == 0) {
+                    //槽空闲，抢占该位置
+                    if(enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }else if(diff < 0) {
+                    return false; //队列满
+                }else {
+                    pos = enqueue_pos.load(std::memory_order_relaxed); //被别人抢先，重读
+                }
+            }
+            construct(&c->data, x);
+            c->sequence.store(pos + 1, std::memory_order_release);
+            not_empty.notify();
+            return true;
+        }
+        bool try_pop(value_type& x) {
+            cell* c;
+            size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            for(;;) {
+                c = &buffer[pos & mask];
+                size_t seq = c->sequence.load(std::memory_order_acquire);
+                intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+                if(diff == 0) {
+                    if(dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }else if(diff < 0) {
+                    return false; //队列空
+                }else {
+                    pos = dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            x = std::move(c->data);
+            destroy(&c->data);
+            //下一轮(pos + 容量)的生产者可以使用该槽
+            c->sequence.store(pos + mask + 1, std::memory_order_release);
+            not_full.notify();
+            return true;
+        }
+        //阻塞版本，满时按WaitStrategy等待
+        void push(const value_type& x) {
+            while(!try_push(x)) {
+                uint32_t e = not_full.prepare_wait();
+                if(try_push(x)) {
+                    not_full.cancel_wait();
+                    return;
+                }
+                not_full.wait(e);
+            }
+        }
+        //阻塞版本，空时按WaitStrategy等待
+        void pop(value_type& x) {
+            while(!try_pop(x)) {
+                uint32_t e = not_empty.prepare_wait();
+                if(try_pop(x)) {
+                    not_empty.cancel_wait();
+                    return;
+                }
+                not_empty.wait(e);
+            }
+        }
+    };
+}
+#endif //MY_STL_MPMC_QUEUE_H
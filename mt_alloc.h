@@ -0,0 +1,44 @@
+#ifndef MY_STL_MT_ALLOC_H
+#define MY_STL_MT_ALLOC_H
+//多线程可用的第二级配置器
+//alloc(_default_alloc_template<0>)不讨论多线程；这里用另一个实例<1>的内存池，外面加一把自旋锁
+//单线程容器继续使用alloc，不付出加锁的代价
+#include <atomic>
+#include <thread>
+#include "alloc.h"
+namespace my_stl{
+    template <int inst>
+    class _mt_alloc_template {
+    private:
+        typedef _default_alloc_template<inst + 1> pool;
+        static std::atomic_flag lock_flag;
+
+        struct lock_guard {
+            lock_guard() {
+                while(lock_flag.test_and_set(std::memory_order_acquire))
+                    std::this_thread::yield();
+            }
+            ~lock_guard() { lock_flag.clear(std::memory_order_release); }
+        };
+    public:
+        static void *allocate(size_t n) {
+            //大块直接走malloc，本身线程安全，不必加锁
+            if(n > (size_t) _max_bytes)
+                return malloc_alloc::allocate(n);
+            lock_guard g;
+            return pool::allocate(n);
+        }
+        static void deallocate(void *p, size_t n) {
+            if(n > (size_t) _max_bytes) {
+                malloc_alloc::deallocate(p, n);
+                return;
+            }
+            lock_guard g;
+            pool::deallocate(p, n);
+        }
+    };
+    template <int inst>
+    std::atomic_flag _mt_alloc_template<inst>::lock_flag = ATOMIC_FLAG_INIT;
+    typedef _mt_alloc_template<0> mt_alloc;
+}
+#endif //MY_STL_MT_ALLOC_H
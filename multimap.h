@@ -0,0 +1,83 @@
+#ifndef MY_STL_MULTIMAP_H
+#define MY_STL_MULTIMAP_H
+//multimap：与map相同，但键值允许重复，没有operator[]
+#include "rb-tree.h"
+#include "functional.h"
+#include "pair.h"
+namespace my_stl{
+    template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+    class multimap {
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+        typedef Compare key_compare;
+        //按键值比较两个元素
+        class value_compare : public binary_function<value_type, value_type, bool> {
+            friend class multimap;
+        protected:
+            Compare comp;
+            value_compare(Compare c) : comp(c) {}
+        public:
+            bool operator() (const value_type& x, const value_type& y) const { return comp(x.first, y.first); }
+        };
+    protected:
+        typedef rb_tree<key_type, value_type, select1st<value_type>, key_compare, Alloc> rep_type;
+        rep_type t;
+    public:
+        typedef typename rep_type::pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        //可以通过迭代器改变second，first是const的
+        typedef typename rep_type::iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+
+        multimap() : t(Compare()) {}
+        explicit multimap(const Compare& comp) : t(comp) {}
+        template <class InputIterator>
+        multimap(InputIterator first, InputIterator last) : t(Compare()) { t.insert_equal(first, last); }
+        template <class InputIterator>
+        multimap(InputIterator first, InputIterator last, const Compare& comp) : t(comp) { t.insert_equal(first, last); }
+
+        key_compare key_comp() const { return t.key_comp(); }
+        value_compare value_comp() const { return value_compare(t.key_comp()); }
+        iterator begin() { return t.begin(); }
+        iterator end() { return t.end(); }
+        const_iterator begin() const { return t.begin(); }
+        const_iterator end() const { return t.end(); }
+        bool empty() const { return t.empty(); }
+        size_type size() const { return t.size(); }
+        size_type max_size() const { return t.max_size(); }
+        void swap(multimap& x) { t.swap(x.t); }
+
+        iterator insert(const value_type& x) { return t.insert_equal(x); }
+        iterator insert(iterator position, const value_type& x) { return t.insert_equal(position, x); }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) { t.insert_equal(first, last); }
+        void erase(iterator position) { t.erase(position); }
+        size_type erase(const key_type& x) { return t.erase(x); }
+        void erase(iterator first, iterator last) { t.erase(first, last); }
+        void clear() { t.clear(); }
+        //由已排序的区间以O(n)重建，原有元素被清除
+        template <class ForwardIterator>
+        void build_from_sorted(ForwardIterator first, ForwardIterator last) { t.build_from_sorted(first, last); }
+
+        iterator find(const key_type& x) { return t.find(x); }
+        const_iterator find(const key_type& x) const { return t.find(x); }
+        size_type count(const key_type& x) const { return t.count(x); }
+        iterator lower_bound(const key_type& x) { return t.lower_bound(x); }
+        const_iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+        iterator upper_bound(const key_type& x) { return t.upper_bound(x); }
+        const_iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+        pair<iterator, iterator> equal_range(const key_type& x) { return t.equal_range(x); }
+        pair<const_iterator, const_iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+        friend bool operator== (const multimap& x, const multimap& y) { return x.t == y.t; }
+        friend bool operator< (const multimap& x, const multimap& y) { return x.t < y.t; }
+    };
+}
+#endif //MY_STL_MULTIMAP_H
@@ -0,0 +1,167 @@
+#ifndef MY_STL_MULTIQUEUE_H
+#define MY_STL_MULTIQUEUE_H
+//并发优先队列(MultiQueue)：元素分散在若干个各自加锁的堆(分片)中
+//push随机选一个分片；try_pop随机选两个分片，比较堆顶后从较优的那个弹出
+//这是松弛的优先队列：弹出的不一定是全局最优，但期望排名误差与分片数同阶，不随元素个数增长
+//分片数是质量与吞吐量之间的旋钮：分片越多锁冲突越少，弹出顺序离严格优先级越远；1个分片时退化为加锁的priority_queue
+//一般取线程数的2~4倍；调度器等只需要“大致按截止时间”的场合足够
+//加锁只用try_lock，抢不到就换分片，所以不会死锁，也不会在某个繁忙的分片上排队
+//分片的vector频繁增长，默认用malloc_alloc，避免mt_alloc那把全局锁
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "alloc.h"
+#include "cons.h"
+#include "vector.h"
+#include "heap.h"
+#include "functional.h"
+namespace my_stl{
+    //分片：一把自旋锁、一个堆和堆的大小，独占cache line(分片数组由multiqueue按64字节对齐)
+    //count在锁内更新，锁外读取，用于不加锁地跳过空分片
+    template <class T, class Alloc>
+    struct alignas(64) _mq_shard {
+        std::atomic<bool> locked;
+        std::atomic<size_t> count;
+        vector<T, Alloc> heap;
+
+        _mq_shard() : locked(false), count(0) {}
+        bool try_lock() {
+            return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+        }
+        void lock() {
+            while(locked.exchange(true, std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+        void unlock() { locked.store(false, std::memory_order_release); }
+    };
+
+    //堆顶为comp意义下最大的元素，按截止时间调度时Compare取greater
+    template <class T, class Compare = less<T>, size_t Arity = 4, class Alloc = malloc_alloc>
+    class multiqueue {
+    public:
+        typedef T value_type;
+        typedef size_t size_type;
+    protected:
+        typedef _mq_shard<T, Alloc> shard;
+        typedef my_alloc<char, Alloc> byte_allocator;
+
+        char* storage;  //配置器不保证64字节对齐，多配一些再在其中对齐
+        shard* shards;
+        size_type nshards;
+        Compare comp;
+
+        //每个线程一个xorshift状态
+        static uint64_t next_random() {
+            static thread_local uint64_t s = 0;
+            if(s == 0) s = uint64_t(uintptr_t(&s)) * 0x9E3779B97F4A7C15ull | 1;
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            return s;
+        }
+        static size_t storage_bytes(size_type n) { return n * sizeof(shard) + alignof(shard) - 1; }
+        shard* random_shard() { return &shards[next_random() % nshards]; }
+        //调用者持有p的锁且p非空
+        void pop_locked(shard* p, value_type& out) {
+            out = p->heap[0];
+            pop_heap<Arity>(p->heap.begin(), p->heap.end(), comp);
+            p->heap.pop_back();
+            p->count.store(p->heap.size(), std::memory_order_relaxed);
+        }
+        //随机选择多次都落空后的兜底：依次查看每个分片，只有全部为空才返回false
+        bool pop_scan(value_type& out) {
+            for(size_type i = 0; i != nshards; ++i) {
+                shard* p = &shards[i];
+                if(p->count.load(std::memory_order_relaxed) == 0) continue;
+                p->lock();
+                if(!p->heap.empty()) {
+                    pop_locked(p, out);
+                    p->unlock();
+                    return true;
+                }
+                p->unlock();
+            }
+            return false;
+        }
+    private:
+        multiqueue(const multiqueue&);
+        multiqueue& operator= (const multiqueue&);
+    public:
+        //n为分片数，0表示取硬件线程数的2倍
+        explicit multiqueue(size_type n = 0, const Compare& x = Compare()) : comp(x) {
+            if(n == 0) n = 2 * size_type(std::thread::hardware_concurrency());
+            if(n == 0) n = 2;
+            nshards = n;
+            storage = byte_allocator::allocate(storage_bytes(n));
+            shards = reinterpret_cast<shard*>((reinterpret_cast<uintptr_t>(storage) + alignof(shard) - 1)
+                                              & ~uintptr_t(alignof(shard) - 1));
+            for(size_type i = 0; i != n; ++i)
+                new(&shards[i]) shard();
+        }
+        ~multiqueue() {
+            for(size_type i = 0; i != nshards; ++i)
+                destroy(&shards[i]);
+            byte_allocator::deallocate(storage, storage_bytes(nshards));
+        }
+
+        size_type shard_count() const { return nshards; }
+        //有并发修改时只是近似值
+        size_type size() const {
+            size_type n = 0;
+            for(size_type i = 0; i != nshards; ++i)
+                n += shards[i].count.load(std::memory_order_relaxed);
+            return n;
+        }
+        bool empty() const { return size() == 0; }
+
+        void push(const value_type& x) {
+            shard* p = random_shard();
+            while(!p->try_lock())
+                p = random_shard();
+            p->heap.push_back(x);
+            push_heap<Arity>(p->heap.begin(), p->heap.end(), comp);
+            p->count.store(p->heap.size(), std::memory_order_relaxed);
+            p->unlock();
+        }
+        //弹出一个(近似)最优的元素；队列为空时返回false
+        bool try_pop(value_type& out) {
+            for(size_type tries = 0; tries != nshards; ++tries) {
+                shard* a = random_shard();
+                shard* b = random_shard();
+                //先按count筛掉空分片，少抢几次锁
+                if(a->count.load(std::memory_order_relaxed) == 0) {
+                    a = b;
+                    b = 0;
+                }
+                if(a == b || (b && b->count.load(std::memory_order_relaxed) == 0)) b = 0;
+                if(a->count.load(std::memory_order_relaxed) == 0) continue;
+                if(!a->try_lock()) {
+                    if(!b || !b->try_lock()) continue;
+                    a = b;
+                    b = 0;
+                }else if(b && !b->try_lock()) {
+                    b = 0;
+                }
+                //两把锁都拿到时比较堆顶，放掉较差的一个
+                if(b) {
+                    if(a->heap.empty() || (!b->heap.empty() && comp(a->heap[0], b->heap[0]))) {
+                        shard* t = a;
+                        a = b;
+                        b = t;
+                    }
+                    b->unlock();
+                }
+                if(!a->heap.empty()) {
+                    pop_locked(a, out);
+                    a->unlock();
+                    return true;
+                }
+                a->unlock();
+            }
+            return pop_scan(out);
+        }
+    };
+}
+#endif //MY_STL_MULTIQUEUE_H
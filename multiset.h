@@ -0,0 +1,70 @@
+#ifndef MY_STL_MULTISET_H
+#define MY_STL_MULTISET_H
+//multiset：与set相同，但键值允许重复
+#include "rb-tree.h"
+#include "functional.h"
+namespace my_stl{
+    template <class Key, class Compare = less<Key>, class Alloc = alloc>
+    class multiset {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+    protected:
+        typedef rb_tree<key_type, value_type, identity<value_type>, key_compare, Alloc> rep_type;
+        rep_type t;
+    public:
+        typedef typename rep_type::const_pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::const_reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        //不允许通过迭代器改变元素值，iterator也是const_iterator
+        typedef typename rep_type::const_iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+
+        multiset() : t(Compare()) {}
+        explicit multiset(const Compare& comp) : t(comp) {}
+        template <class InputIterator>
+        multiset(InputIterator first, InputIterator last) : t(Compare()) { t.insert_equal(first, last); }
+        template <class InputIterator>
+        multiset(InputIterator first, InputIterator last, const Compare& comp) : t(comp) { t.insert_equal(first, last); }
+
+        key_compare key_comp() const { return t.key_comp(); }
+        value_compare value_comp() const { return t.key_comp(); }
+        iterator begin() const { return t.begin(); }
+        iterator end() const { return t.end(); }
+        bool empty() const { return t.empty(); }
+        size_type size() const { return t.size(); }
+        size_type max_size() const { return t.max_size(); }
+        void swap(multiset& x) { t.swap(x.t); }
+
+        iterator insert(const value_type& x) { return t.insert_equal(x); }
+        iterator insert(iterator position, const value_type& x) {
+            return t.insert_equal((typename rep_type::iterator&) position, x);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) { t.insert_equal(first, last); }
+        void erase(iterator position) { t.erase((typename rep_type::iterator&) position); }
+        size_type erase(const key_type& x) { return t.erase(x); }
+        void erase(iterator first, iterator last) {
+            t.erase((typename rep_type::iterator&) first, (typename rep_type::iterator&) last);
+        }
+        void clear() { t.clear(); }
+        //由已排序的区间以O(n)重建，原有元素被清除
+        template <class ForwardIterator>
+        void build_from_sorted(ForwardIterator first, ForwardIterator last) { t.build_from_sorted(first, last); }
+
+        iterator find(const key_type& x) const { return t.find(x); }
+        size_type count(const key_type& x) const { return t.count(x); }
+        iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+        iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+        pair<iterator, iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+        friend bool operator== (const multiset& x, const multiset& y) { return x.t == y.t; }
+        friend bool operator< (const multiset& x, const multiset& y) { return x.t < y.t; }
+    };
+}
+#endif //MY_STL_MULTISET_H
@@ -0,0 +1,177 @@
+#ifndef MY_STL_OS_TREE_H
+#define MY_STL_OS_TREE_H
+//顺序统计树：每个节点额外记录子树的节点数，旋转和插入删除时随之维护
+//select(k)取第k小的元素，rank(key)求小于key的元素个数，迭代器的前进与距离都是O(log n)
+#include <cstddef>
+#include "rb-tree.h"
+#include "functional.h"
+#include "pair.h"
+namespace my_stl{
+    template <class Value>
+    struct _rb_tree_size_node : public _rb_tree_node<Value> {
+        size_t count; //以本节点为根的子树的节点数
+    };
+    //维护子树大小的增强策略
+    struct rb_tree_size_augment {
+        static const bool enabled = true;
+        template <class Value> struct node { typedef _rb_tree_size_node<Value> type; };
+        template <class Node>
+        static size_t count(_rb_tree_node_base* x) { return x ? ((Node*) x) -> count : 0; }
+        template <class Node>
+        static void update(Node* x) { x -> count = 1 + count<Node>(x -> left) + count<Node>(x -> right); }
+        template <class Node>
+        static void clone(Node* to, const Node* from) { to -> count = from -> count; }
+    };
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc = alloc>
+    class os_rb_tree : public rb_tree<Key, Value, KeyOfValue, Compare, Alloc, rb_tree_size_augment> {
+    protected:
+        typedef rb_tree<Key, Value, KeyOfValue, Compare, Alloc, rb_tree_size_augment> base_tree;
+        typedef typename base_tree::rb_tree_node rb_tree_node;
+        typedef _rb_tree_node_base* base_ptr;
+        static size_t count(base_ptr x) { return rb_tree_size_augment::count<rb_tree_node>(x); }
+
+        //第k小(从0起)的节点，k不小于size()时返回header
+        base_ptr select_node(size_t k) const {
+            base_ptr x = this -> root();
+            while(x != 0) {
+                size_t l = count(x -> left);
+                if(k < l) {
+                    x = x -> left;
+                }else if(k == l) {
+                    return x;
+                }else {
+                    k -= l + 1;
+                    x = x -> right;
+                }
+            }
+            return this -> header_ptr();
+        }
+        //节点x在中序中的下标，header的下标为size()
+        size_t index_node(base_ptr x) const {
+            if(x == this -> header_ptr()) return this -> size();
+            size_t r = count(x -> left);
+            while(x != this -> root()) {
+                base_ptr p = x -> parent();
+                if(x == p -> right)
+                    r += count(p -> left) + 1;
+                x = p;
+            }
+            return r;
+        }
+    public:
+        typedef typename base_tree::key_type key_type;
+        typedef typename base_tree::size_type size_type;
+        typedef typename base_tree::difference_type difference_type;
+        typedef typename base_tree::iterator iterator;
+        typedef typename base_tree::const_iterator const_iterator;
+
+        os_rb_tree(const Compare& comp = Compare()) : base_tree(comp) {}
+
+        //第k小(从0起)的元素，k >= size()时返回end()
+        iterator select(size_type k) { return iterator(select_node(k)); }
+        const_iterator select(size_type k) const { return const_iterator(select_node(k)); }
+        //小于k的元素个数，即lower_bound(k)的下标
+        size_type rank(const key_type& k) const {
+            size_type r = 0;
+            base_ptr x = this -> root();
+            while(x != 0) {
+                if(!this -> key_compare(base_tree::key(x), k)) {
+                    x = x -> left;
+                }else {
+                    r += count(x -> left) + 1;
+                    x = x -> right;
+                }
+            }
+            return r;
+        }
+        //迭代器的下标，end()的下标为size()
+        size_type index_of(const_iterator it) const { return index_node(it.node); }
+        //O(log n)的advance与distance，代替逐个递增的my_stl::advance/distance
+        void advance(iterator& it, difference_type n) const {
+            it = iterator(select_node(size_type(difference_type(index_node(it.node)) + n)));
+        }
+        difference_type distance(const_iterator first, const_iterator last) const {
+            return difference_type(index_node(last.node)) - difference_type(index_node(first.node));
+        }
+    };
+
+    //支持select/rank的set；同set，不允许通过迭代器改变元素值
+    template <class Key, class Compare = less<Key>, class Alloc = alloc>
+    class os_set {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+    protected:
+        typedef os_rb_tree<Key, Key, identity<Key>, Compare, Alloc> rep_type;
+        rep_type t;
+    public:
+        typedef typename rep_type::const_pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::const_reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        typedef typename rep_type::const_iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+
+        os_set(const Compare& comp = Compare()) : t(comp) {}
+
+        iterator begin() const { return t.begin(); }
+        iterator end() const { return t.end(); }
+        bool empty() const { return t.empty(); }
+        size_type size() const { return t.size(); }
+        size_type max_size() const { return t.max_size(); }
+        void swap(os_set& x) { t.swap(x.t); }
+
+        pair<iterator, bool> insert(const value_type& x) {
+            pair<typename rep_type::iterator, bool> p = t.insert_unique(x);
+            return pair<iterator, bool>(p.first, p.second);
+        }
+        iterator insert(iterator position, const value_type& x) {
+            return t.insert_unique((typename rep_type::iterator&) position, x);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) { t.insert_unique(first, last); }
+        void erase(iterator position) { t.erase((typename rep_type::iterator&) position); }
+        size_type erase(const key_type& x) { return t.erase(x); }
+        void erase(iterator first, iterator last) {
+            t.erase((typename rep_type::iterator&) first, (typename rep_type::iterator&) last);
+        }
+        void clear() { t.clear(); }
+
+        iterator find(const key_type& x) const { return t.find(x); }
+        size_type count(const key_type& x) const { return t.count(x); }
+        iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+        iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+        pair<iterator, iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+        iterator select(size_type k) const { return t.select(k); }
+        size_type rank(const key_type& k) const { return t.rank(k); }
+        size_type index_of(iterator it) const { return t.index_of(it); }
+        void advance(iterator& it, difference_type n) const { t.advance((typename rep_type::iterator&) it, n); }
+        difference_type distance(iterator first, iterator last) const { return t.distance(first, last); }
+
+        friend bool operator== (const os_set& x, const os_set& y) { return x.t == y.t; }
+        friend bool operator< (const os_set& x, const os_set& y) { return x.t < y.t; }
+    };
+    //支持select/rank的map
+    template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+    class os_map : public os_rb_tree<Key, pair<const Key, T>, select1st<pair<const Key, T> >, Compare, Alloc> {
+        typedef os_rb_tree<Key, pair<const Key, T>, select1st<pair<const Key, T> >, Compare, Alloc> base_tree;
+    public:
+        typedef pair<const Key, T> value_type;
+        typedef typename base_tree::iterator iterator;
+        os_map(const Compare& comp = Compare()) : base_tree(comp) {}
+        pair<iterator, bool> insert(const value_type& x) { return this -> insert_unique(x); }
+        T& operator[] (const Key& k) {
+            iterator i = this -> lower_bound(k);
+            if(i == this -> end() || this -> key_compare(k, (*i).first))
+                i = this -> insert_unique(i, value_type(k, T()));
+            return (*i).second;
+        }
+    };
+}
+#endif //MY_STL_OS_TREE_H
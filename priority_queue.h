@@ -2,9 +2,11 @@
 #define MY_STL_PRIORITY_QUEUE_H
 #include "vector.h"
 #include "heap.h"
-//暂不支持改变compare
+#include "functional.h"
+//堆顶为comp意义下最大的元素，Compare取greater即为小顶堆
+//Arity为堆的叉数，元素很多时4叉或8叉堆的pop更快
 namespace my_stl{
-    template <class T, class Sequence = vector<T>>
+    template <class T, class Sequence = vector<T>, class Compare = less<typename Sequence::value_type>, size_t Arity = 2>
     class priority_queue {
     public:
         typedef typename Sequence::value_type value_type;
@@ -12,10 +14,21 @@ namespace my_stl{
         typedef typename Sequence::reference reference;
     protected:
         Sequence c;
+        Compare comp;
     public:
-        priority_queue() : c() {}
-        priority_queue(InputIterator first, InputIterator last) : c(first, last) {
-            make_heap(c.begin(), c.end();
+        priority_queue() : c(), comp() {}
+        explicit priority_queue(const Compare& x) : c(), comp(x) {}
+        template <class InputIterator>
+        priority_queue(InputIterator first, InputIterator last) : c(), comp() {
+            for(; first != last; ++first)
+                c.push_back(*first);
+            make_heap<Arity>(c.begin(), c.end(), comp);
+        }
+        template <class InputIterator>
+        priority_queue(InputIterator first, InputIterator last, const Compare& x) : c(), comp(x) {
+            for(; first != last; ++first)
+                c.push_back(*first);
+            make_heap<Arity>(c.begin(), c.end(), comp);
         }
         bool empty() const {
             return c.empty();
@@ -28,12 +41,25 @@ namespace my_stl{
         }
         void push(const value_type& x) {
             c.push_back(x);
-            push_heap(c.begin(),c.end());
+            push_heap<Arity>(c.begin(), c.end(), comp);
         }
         void pop() {
-            pop_heap(c.begin(), c.end());
+            pop_heap<Arity>(c.begin(), c.end(), comp);
             c.pop_back();
         }
+        //批量插入：新元素不少于原有元素时整体make_heap，O(n + m)；否则逐个上浮，随机数据平均每个O(1)
+        template <class InputIterator>
+        void push_range(InputIterator first, InputIterator last) {
+            size_type old = c.size();
+            for(; first != last; ++first)
+                c.push_back(*first);
+            size_type n = c.size();
+            if(n - old >= old)
+                make_heap<Arity>(c.begin(), c.end(), comp);
+            else
+                for(size_type i = old + 1; i <= n; ++i)
+                    push_heap<Arity>(c.begin(), c.begin() + i, comp);
+        }
     };
 }
 #endif //MY_STL_PRIORITY_QUEUE_H
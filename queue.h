@@ -5,10 +5,10 @@
 namespace my_stl{
     template <class T, class Sequence = deque<T> >
     class queue {
-        friend bool operator == <> (const queue& x, const queue& y){
+        friend bool operator== (const queue& x, const queue& y){
             return x.c == y.c;
         }
-        friend bool operator < <> (const queue& x, const queue& y){
+        friend bool operator< (const queue& x, const queue& y){
             return x.c < y.c;
         }
 
@@ -25,10 +25,10 @@ namespace my_stl{
         size_type size() const {
             return c.size();
         }
-        reference front() const {
+        reference front() {
             return c.front();
         }
-        reference back() const {
+        reference back() {
             return c.back();
         }
         void push(const value_type& x) {
@@ -1,17 +1,28 @@
 #ifndef MY_STL_RB_TREE_H
 #define MY_STL_RB_TREE_H
+#include <stdint.h>
 #include "iterator.h"
+#include "alloc.h"
+#include "cons.h"
+#include "pair.h"
 namespace my_stl{
     typedef bool _rb_tree_color_type;
     const _rb_tree_color_type _rb_tree_red = false;
     const _rb_tree_color_type _rb_tree_black = true;
+    //颜色存放在parent指针的最低位(节点至少按指针对齐，最低位恒为0)，节点头部只有三个指针
+    //map<int, int>的节点因此从40字节降到32字节，落入alloc更小的一档
     struct _rb_tree_node_base{
         typedef _rb_tree_color_type color_type;
         typedef _rb_tree_node_base* base_ptr;
-        color_type color; //节点颜色
-        base_ptr parent;
+        uintptr_t parent_color; //父节点指针 | 颜色
         base_ptr left;
         base_ptr right;
+        base_ptr parent() const { return (base_ptr) (parent_color & ~uintptr_t(1)); }
+        color_type color() const { return (parent_color & 1) != 0; }
+        void set_parent(base_ptr p) { parent_color = uintptr_t(p) | (parent_color & 1); }
+        void set_color(color_type c) { parent_color = (parent_color & ~uintptr_t(1)) | uintptr_t(c); }
+        //新节点的parent_color尚未初始化，必须一次写入两者
+        void set_parent_and_color(base_ptr p, color_type c) { parent_color = uintptr_t(p) | uintptr_t(c); }
         static base_ptr minimum(base_ptr x){
             while(x->left != 0)
                 x = x -> left;
@@ -40,10 +51,10 @@ namespace my_stl{
                 while(node -> left != 0)
                     node = node -> left;
             }else{
-                base_ptr y = node -> parent;
+                base_ptr y = node -> parent();
                 while(node == y -> right){
                     node = y;
-                    y = y -> parent;
+                    y = y -> parent();
                 }
                 if(node -> right != y){
                     node = y;
@@ -51,7 +62,7 @@ namespace my_stl{
             }
         }
         void decrement() {
-            if(node -> color == _rb_tree_red && node -> parent -> parent == node)
+            if(node -> color() == _rb_tree_red && node -> parent() -> parent() == node)
                 node = node -> right;
             else if(node -> left != 0){
                 base_ptr y = node -> left;
@@ -59,15 +70,21 @@ namespace my_stl{
                     y = y -> right;
                 node = y;
             }else{
-                base_ptr y = node -> parent;
+                base_ptr y = node -> parent();
                 while(node == y -> left){
                     node = y;
-                    y = y -> parent;
+                    y = y -> parent();
                 }
                 node = y;
             }
         }
     };
+    inline bool operator== (const _rb_tree_base_iterator& x, const _rb_tree_base_iterator& y) {
+        return x.node == y.node;
+    }
+    inline bool operator!= (const _rb_tree_base_iterator& x, const _rb_tree_base_iterator& y) {
+        return x.node != y.node;
+    }
     template <class Value, class Ref, class Ptr>
     struct _rb_tree_iterator : public _rb_tree_base_iterator{
         typedef Value value_type;
@@ -81,9 +98,17 @@ namespace my_stl{
         _rb_tree_iterator(link_type x) {
             node = x;
         }
+        _rb_tree_iterator(base_ptr x) {
+            node = x;
+        }
         _rb_tree_iterator(const iterator& it) {
             node = it.node;
         }
+        //对iterator而言上面是复制构造函数，复制赋值也要一并声明
+        self& operator= (const iterator& it) {
+            node = it.node;
+            return *this;
+        }
         reference operator* () const {
             return link_type(node) -> value_field;
         }
@@ -109,5 +134,943 @@ namespace my_stl{
             return tmp;
         }
     };
+
+    //增强策略：在节点中维护由子树推出的附加信息(例如子树大小)
+    //update(x)由x的左右子节点重新计算x的附加信息；enabled为false时rb_tree跳过所有维护工作
+    struct rb_tree_no_augment {
+        static const bool enabled = false;
+        template <class Value> struct node { typedef _rb_tree_node<Value> type; };
+        template <class Node> static void update(Node*) {}
+        //复制子树时复制附加信息
+        template <class Node> static void clone(Node*, const Node*) {}
+    };
+    //把增强策略绑定到具体的节点类型，旋转、删除等只认识_rb_tree_node_base的函数经由它调用update
+    template <class Augment, class Node>
+    struct _rb_tree_augment_hook {
+        static const bool enabled = Augment::enabled;
+        static void update(_rb_tree_node_base* x) { Augment::update((Node*) x); }
+    };
+
+    //左旋：x的右子节点y取代x的位置，x成为y的左子节点
+    template <class Hook>
+    inline void _rb_tree_rotate_left(_rb_tree_node_base* x, _rb_tree_node_base*& root) {
+        _rb_tree_node_base* y = x -> right;
+        x -> right = y -> left;
+        if(y -> left != 0)
+            y -> left -> set_parent(x);
+        y -> set_parent(x -> parent());
+        if(x == root)
+            root = y;
+        else if(x == x -> parent() -> left)
+            x -> parent() -> left = y;
+        else
+            x -> parent() -> right = y;
+        y -> left = x;
+        x -> set_parent(y);
+        Hook::update(x);
+        Hook::update(y);
+    }
+    //右旋：x的左子节点y取代x的位置，x成为y的右子节点
+    template <class Hook>
+    inline void _rb_tree_rotate_right(_rb_tree_node_base* x, _rb_tree_node_base*& root) {
+        _rb_tree_node_base* y = x -> left;
+        x -> left = y -> right;
+        if(y -> right != 0)
+            y -> right -> set_parent(x);
+        y -> set_parent(x -> parent());
+        if(x == root)
+            root = y;
+        else if(x == x -> parent() -> right)
+            x -> parent() -> right = y;
+        else
+            x -> parent() -> left = y;
+        y -> right = x;
+        x -> set_parent(y);
+        Hook::update(x);
+        Hook::update(y);
+    }
+    //新节点x插入后重新平衡：通过变色和旋转消除连续的红节点
+    //返回最后是否把红色的根染黑，即整棵树的黑高度是否加一
+    template <class Hook>
+    inline bool _rb_tree_rebalance(_rb_tree_node_base* x, _rb_tree_node_base*& root) {
+        x -> set_color(_rb_tree_red);
+        while(x != root && x -> parent() -> color() == _rb_tree_red) {
+            if(x -> parent() == x -> parent() -> parent() -> left) {
+                _rb_tree_node_base* y = x -> parent() -> parent() -> right; //伯父节点
+                if(y && y -> color() == _rb_tree_red) {
+                    x -> parent() -> set_color(_rb_tree_black);
+                    y -> set_color(_rb_tree_black);
+                    x -> parent() -> parent() -> set_color(_rb_tree_red);
+                    x = x -> parent() -> parent();
+                }else {
+                    if(x == x -> parent() -> right) {
+                        x = x -> parent();
+                        _rb_tree_rotate_left<Hook>(x, root);
+                    }
+                    x -> parent() -> set_color(_rb_tree_black);
+                    x -> parent() -> parent() -> set_color(_rb_tree_red);
+                    _rb_tree_rotate_right<Hook>(x -> parent() -> parent(), root);
+                }
+            }else {
+                _rb_tree_node_base* y = x -> parent() -> parent() -> left;
+                if(y && y -> color() == _rb_tree_red) {
+                    x -> parent() -> set_color(_rb_tree_black);
+                    y -> set_color(_rb_tree_black);
+                    x -> parent() -> parent() -> set_color(_rb_tree_red);
+                    x = x -> parent() -> parent();
+                }else {
+                    if(x == x -> parent() -> left) {
+                        x = x -> parent();
+                        _rb_tree_rotate_right<Hook>(x, root);
+                    }
+                    x -> parent() -> set_color(_rb_tree_black);
+                    x -> parent() -> parent() -> set_color(_rb_tree_red);
+                    _rb_tree_rotate_left<Hook>(x -> parent() -> parent(), root);
+                }
+            }
+        }
+        bool grew = root -> color() == _rb_tree_red;
+        root -> set_color(_rb_tree_black);
+        return grew;
+    }
+    //把z从树中摘除并重新平衡，返回实际要释放的节点(即z)
+    //z有两个子节点时由其后继y顶替z的位置和颜色
+    template <class Hook>
+    inline _rb_tree_node_base* _rb_tree_rebalance_for_erase(_rb_tree_node_base* z, _rb_tree_node_base*& root,
+                                                            _rb_tree_node_base*& leftmost, _rb_tree_node_base*& rightmost) {
+        _rb_tree_node_base* y = z;
+        _rb_tree_node_base* x = 0;
+        _rb_tree_node_base* x_parent = 0;
+        if(y -> left == 0)
+            x = y -> right;
+        else if(y -> right == 0)
+            x = y -> left;
+        else {
+            y = y -> right;
+            while(y -> left != 0)
+                y = y -> left;
+            x = y -> right;
+        }
+        if(y != z) {
+            //用后继y顶替z
+            z -> left -> set_parent(y);
+            y -> left = z -> left;
+            if(y != z -> right) {
+                x_parent = y -> parent();
+                if(x) x -> set_parent(y -> parent());
+                y -> parent() -> left = x;
+                y -> right = z -> right;
+                z -> right -> set_parent(y);
+            }else {
+                x_parent = y;
+            }
+            if(root == z)
+                root = y;
+            else if(z -> parent() -> left == z)
+                z -> parent() -> left = y;
+            else
+                z -> parent() -> right = y;
+            y -> set_parent(z -> parent());
+            _rb_tree_color_type c = y -> color();
+            y -> set_color(z -> color());
+            z -> set_color(c);
+            y = z;
+        }else {
+            //z至多有一个子节点x，x直接顶替z
+            x_parent = y -> parent();
+            if(x) x -> set_parent(y -> parent());
+            if(root == z)
+                root = x;
+            else if(z -> parent() -> left == z)
+                z -> parent() -> left = x;
+            else
+                z -> parent() -> right = x;
+            if(leftmost == z) {
+                if(z -> right == 0)
+                    leftmost = z -> parent();
+                else
+                    leftmost = _rb_tree_node_base::minimum(x);
+            }
+            if(rightmost == z) {
+                if(z -> left == 0)
+                    rightmost = z -> parent();
+                else
+                    rightmost = _rb_tree_node_base::maximum(x);
+            }
+        }
+        //结构已经改好，从x_parent向上更新附加信息；z为根且被x顶替时x_parent是header，不更新
+        if(Hook::enabled && !(y == z && root == x)) {
+            for(_rb_tree_node_base* p = x_parent; ; p = p -> parent()) {
+                Hook::update(p);
+                if(p == root) break;
+            }
+        }
+        //摘除的是黑节点时，x所在的路径少了一个黑节点，需要修复
+        if(y -> color() != _rb_tree_red) {
+            while(x != root && (x == 0 || x -> color() == _rb_tree_black)) {
+                if(x == x_parent -> left) {
+                    _rb_tree_node_base* w = x_parent -> right; //兄弟节点
+                    if(w -> color() == _rb_tree_red) {
+                        w -> set_color(_rb_tree_black);
+                        x_parent -> set_color(_rb_tree_red);
+                        _rb_tree_rotate_left<Hook>(x_parent, root);
+                        w = x_parent -> right;
+                    }
+                    if((w -> left == 0 || w -> left -> color() == _rb_tree_black) &&
+                       (w -> right == 0 || w -> right -> color() == _rb_tree_black)) {
+                        w -> set_color(_rb_tree_red);
+                        x = x_parent;
+                        x_parent = x_parent -> parent();
+                    }else {
+                        if(w -> right == 0 || w -> right -> color() == _rb_tree_black) {
+                            if(w -> left) w -> left -> set_color(_rb_tree_black);
+                            w -> set_color(_rb_tree_red);
+                            _rb_tree_rotate_right<Hook>(w, root);
+                            w = x_parent -> right;
+                        }
+                        w -> set_color(x_parent -> color());
+                        x_parent -> set_color(_rb_tree_black);
+                        if(w -> right) w -> right -> set_color(_rb_tree_black);
+                        _rb_tree_rotate_left<Hook>(x_parent, root);
+                        break;
+                    }
+                }else {
+                    _rb_tree_node_base* w = x_parent -> left;
+                    if(w -> color() == _rb_tree_red) {
+                        w -> set_color(_rb_tree_black);
+                        x_parent -> set_color(_rb_tree_red);
+                        _rb_tree_rotate_right<Hook>(x_parent, root);
+                        w = x_parent -> left;
+                    }
+                    if((w -> right == 0 || w -> right -> color() == _rb_tree_black) &&
+                       (w -> left == 0 || w -> left -> color() == _rb_tree_black)) {
+                        w -> set_color(_rb_tree_red);
+                        x = x_parent;
+                        x_parent = x_parent -> parent();
+                    }else {
+                        if(w -> left == 0 || w -> left -> color() == _rb_tree_black) {
+                            if(w -> right) w -> right -> set_color(_rb_tree_black);
+                            w -> set_color(_rb_tree_red);
+                            _rb_tree_rotate_left<Hook>(w, root);
+                            w = x_parent -> left;
+                        }
+                        w -> set_color(x_parent -> color());
+                        x_parent -> set_color(_rb_tree_black);
+                        if(w -> left) w -> left -> set_color(_rb_tree_black);
+                        _rb_tree_rotate_right<Hook>(x_parent, root);
+                        break;
+                    }
+                }
+            }
+            if(x) x -> set_color(_rb_tree_black);
+        }
+        return y;
+    }
+
+    //集合运算中丢弃的节点：若干棵子树，子树的根经由parent串成链，最后在调用者的线程里统一释放
+    struct _rb_tree_garbage {
+        _rb_tree_node_base* head;
+        _rb_tree_node_base* tail;
+        _rb_tree_garbage() : head(0), tail(0) {}
+        void push(_rb_tree_node_base* t) {
+            if(t == 0) return;
+            t -> set_parent(0);
+            if(tail) tail -> set_parent(t);
+            else head = t;
+            tail = t;
+        }
+        void push_node(_rb_tree_node_base* x) {
+            x -> left = 0;
+            x -> right = 0;
+            push(x);
+        }
+        void splice(_rb_tree_garbage& x) {
+            if(x.head == 0) return;
+            if(tail) tail -> set_parent(x.head);
+            else head = x.head;
+            tail = x.tail;
+        }
+    };
+    //分治算法的分叉策略：顺序执行两个子问题；并行的版本见thread_pool.h中的pool_fork
+    struct serial_fork {
+        template <class F1, class F2>
+        void operator() (F1& f1, F2& f2, int) const {
+            f1();
+            f2();
+        }
+    };
+
+    //红黑树
+    //header是嵌在对象中的哨兵：header.parent()指向根，header.left指向最小节点，header.right指向最大节点
+    //header为红色，以便decrement()区分header与根(end()递减得到最大节点)
+    //Augment为增强策略，见rb_tree_no_augment
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc = alloc, class Augment = rb_tree_no_augment>
+    class rb_tree {
+    protected:
+        typedef _rb_tree_node_base* base_ptr;
+        typedef typename Augment::template node<Value>::type rb_tree_node;
+        typedef _rb_tree_augment_hook<Augment, rb_tree_node> augment_hook;
+        typedef my_alloc<rb_tree_node, Alloc> rb_tree_node_allocator;
+        typedef _rb_tree_color_type color_type;
+    public:
+        typedef Key key_type;
+        typedef Value value_type;
+        typedef value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef rb_tree_node* link_type;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _rb_tree_iterator<value_type, reference, pointer> iterator;
+        typedef _rb_tree_iterator<value_type, const_reference, const_pointer> const_iterator;
+    protected:
+        _rb_tree_node_base header;
+        size_type node_count; //节点数量
+        Compare key_compare;  //键值大小比较准则
+
+        link_type get_node() { return rb_tree_node_allocator::allocate(); }
+        void put_node(link_type p) { rb_tree_node_allocator::deallocate(p); }
+        link_type create_node(const value_type& x) {
+            link_type tmp = get_node();
+            try {
+                construct(&tmp -> value_field, x);
+            }
+            catch(...) {
+                put_node(tmp);
+                throw;
+            }
+            return tmp;
+        }
+        //复制一个节点的值和颜色
+        link_type clone_node(base_ptr x) {
+            link_type tmp = create_node(value(x));
+            tmp -> set_parent_and_color(0, x -> color());
+            tmp -> left = 0;
+            tmp -> right = 0;
+            Augment::clone(tmp, (link_type) x);
+            return tmp;
+        }
+        void destroy_node(link_type p) {
+            destroy(&p -> value_field);
+            put_node(p);
+        }
+
+        //根存放在header的parent_color中，header恒为红色(最低位为0)
+        base_ptr root() const { return header.parent(); }
+        void set_root(base_ptr x) { header.set_parent(x); }
+        base_ptr& leftmost() const { return (base_ptr&) header.left; }
+        base_ptr& rightmost() const { return (base_ptr&) header.right; }
+        base_ptr header_ptr() const { return const_cast<base_ptr>(&header); }
+        static reference value(base_ptr x) { return ((link_type) x) -> value_field; }
+        static const Key& key(base_ptr x) { return KeyOfValue()(value(x)); }
+
+        void empty_initialize() {
+            header.set_parent_and_color(0, _rb_tree_red);
+            leftmost() = &header;
+            rightmost() = &header;
+            node_count = 0;
+        }
+        //x为新节点的插入点(只用于判断插左还是插右)，y为插入点的父节点
+        iterator insert(base_ptr x, base_ptr y, const value_type& v) {
+            link_type z = create_node(v);
+            if(y == &header || x != 0 || key_compare(KeyOfValue()(v), key(y))) {
+                y -> left = z; //y为header时，同时令leftmost()为z
+                if(y == &header) {
+                    set_root(z);
+                    rightmost() = z;
+                }else if(y == leftmost()) {
+                    leftmost() = z;
+                }
+            }else {
+                y -> right = z;
+                if(y == rightmost())
+                    rightmost() = z;
+            }
+            z -> set_parent_and_color(y, _rb_tree_red);
+            z -> left = 0;
+            z -> right = 0;
+            if(augment_hook::enabled) {
+                for(base_ptr p = z; p != &header; p = p -> parent())
+                    augment_hook::update(p);
+            }
+            base_ptr r = root();
+            _rb_tree_rebalance<augment_hook>(z, r);
+            set_root(r);
+            ++node_count;
+            return iterator(z);
+        }
+        //复制以x为根的子树，新子树的根挂在p下；沿右子树递归，沿左子树迭代
+        link_type copy(base_ptr x, base_ptr p) {
+            link_type top = clone_node(x);
+            top -> set_parent(p);
+            try {
+                if(x -> right)
+                    top -> right = copy(x -> right, top);
+                p = top;
+                x = x -> left;
+                while(x != 0) {
+                    link_type y = clone_node(x);
+                    p -> left = y;
+                    y -> set_parent(p);
+                    if(x -> right)
+                        y -> right = copy(x -> right, y);
+                    p = y;
+                    x = x -> left;
+                }
+            }
+            catch(...) {
+                erase_subtree(top);
+                throw;
+            }
+            return top;
+        }
+        //销毁以x为根的子树，不做平衡，返回销毁的节点数
+        size_type erase_subtree(base_ptr x) {
+            size_type n = 0;
+            while(x != 0) {
+                n += erase_subtree(x -> right);
+                base_ptr y = x -> left;
+                destroy_node((link_type) x);
+                ++n;
+                x = y;
+            }
+            return n;
+        }
+        //把独立的子树t(可以为空)装回本树，t共有n个节点
+        void reset_root(base_ptr t, size_type n) {
+            if(t == 0) {
+                empty_initialize();
+                return;
+            }
+            t -> set_parent_and_color(&header, _rb_tree_black);
+            set_root(t);
+            leftmost() = _rb_tree_node_base::minimum(t);
+            rightmost() = _rb_tree_node_base::maximum(t);
+            node_count = n;
+        }
+
+        //以下函数操作独立的子树：不属于任何header，根可以是红色，根的parent没有意义
+        //子树的黑高度按根为黑色计(连接时根会被染黑)，空树为0
+        //数一次要O(log n)，所以只在最外层数；递归中由父节点的黑高度推出子节点的，随结果一起返回
+        static size_t black_height(base_ptr x) {
+            size_t h = (x != 0 && x -> color() == _rb_tree_red) ? 1 : 0;
+            for(; x != 0; x = x -> left)
+                if(x -> color() == _rb_tree_black) ++h;
+            return h;
+        }
+        //黑高度为h的子树中，子节点c为根的子树的黑高度
+        static size_t child_black_height(base_ptr c, size_t h) {
+            return (c != 0 && c -> color() == _rb_tree_red) ? h : h - 1;
+        }
+        //把键值都不大于k的子树l(黑高度hl)、节点k、键值都不小于k的子树r(黑高度hr)连成一棵树，返回新的根，h为其黑高度
+        //沿较高一侧的边缘找到与较矮一侧黑高度相同的黑节点，以红色的k接上，再像插入一样修复
+        //O(|hl - hr| + 1)
+        static base_ptr join_nodes(base_ptr l, size_t hl, base_ptr k, base_ptr r, size_t hr, size_t& h) {
+            if(l) l -> set_parent_and_color(0, _rb_tree_black);
+            if(r) r -> set_parent_and_color(0, _rb_tree_black);
+            if(hl == hr) {
+                k -> set_parent_and_color(0, _rb_tree_black);
+                k -> left = l;
+                k -> right = r;
+                if(l) l -> set_parent(k);
+                if(r) r -> set_parent(k);
+                augment_hook::update(k);
+                h = hl + 1;
+                return k;
+            }
+            bool left_taller = hl > hr;
+            base_ptr root = left_taller ? l : r;
+            size_t top = left_taller ? hl : hr;
+            size_t target = left_taller ? hr : hl;
+            base_ptr p = 0;
+            base_ptr y = root;
+            for(size_t cur = top; cur != target || (y != 0 && y -> color() == _rb_tree_red); ) {
+                if(y -> color() == _rb_tree_black) --cur;
+                p = y;
+                y = left_taller ? y -> right : y -> left;
+            }
+            k -> left = left_taller ? y : l;
+            k -> right = left_taller ? r : y;
+            if(k -> left) k -> left -> set_parent(k);
+            if(k -> right) k -> right -> set_parent(k);
+            k -> set_parent_and_color(p, _rb_tree_red);
+            if(left_taller) p -> right = k;
+            else p -> left = k;
+            if(augment_hook::enabled) {
+                for(base_ptr x = k; x != 0; x = x -> parent())
+                    augment_hook::update(x);
+            }
+            h = _rb_tree_rebalance<augment_hook>(k, root) ? top + 1 : top;
+            return root;
+        }
+        //摘下子树t中最大的节点并返回，t随之更新
+        static base_ptr split_last(base_ptr& t) {
+            base_ptr z = _rb_tree_node_base::maximum(t);
+            base_ptr lm = 0;
+            base_ptr rm = 0;
+            t -> set_parent(0);
+            return _rb_tree_rebalance_for_erase<augment_hook>(z, t, lm, rm);
+        }
+        //没有中间节点的连接：借l中最大的节点作为中间节点
+        //摘下它已经是O(log n)，再数一次l的黑高度不改变复杂度
+        static base_ptr join2(base_ptr l, size_t hl, base_ptr r, size_t hr, size_t& h) {
+            if(l == 0) {
+                h = hr;
+                return r;
+            }
+            if(r == 0) {
+                h = hl;
+                return l;
+            }
+            base_ptr k = split_last(l);
+            return join_nodes(l, black_height(l), k, r, hr, h);
+        }
+        //把子树t(黑高度ht)分成键值小于k的l和大于k的r，键值等于k的节点(若有)作为返回值，hl、hr为两边的黑高度
+        //沿路径每层一次连接，代价为相邻两次连接的黑高度之差，总和O(log n)
+        base_ptr split_nodes(base_ptr t, size_t ht, const Key& k, base_ptr& l, size_t& hl, base_ptr& r, size_t& hr) const {
+            if(t == 0) {
+                l = r = 0;
+                hl = hr = 0;
+                return 0;
+            }
+            base_ptr tl = t -> left;
+            base_ptr tr = t -> right;
+            size_t htl = child_black_height(tl, ht);
+            size_t htr = child_black_height(tr, ht);
+            if(key_compare(key(t), k)) {
+                base_ptr mid = split_nodes(tr, htr, k, l, hl, r, hr);
+                l = join_nodes(tl, htl, t, l, hl, hl);
+                return mid;
+            }
+            if(key_compare(k, key(t))) {
+                base_ptr mid = split_nodes(tl, htl, k, l, hl, r, hr);
+                r = join_nodes(r, hr, t, tr, htr, hr);
+                return mid;
+            }
+            l = tl;
+            hl = htl;
+            r = tr;
+            hr = htr;
+            return t;
+        }
+        //键值小于k的进l，其余进r，允许键值重复。O(log n)
+        void split_lower(base_ptr t, size_t ht, const Key& k, base_ptr& l, size_t& hl, base_ptr& r, size_t& hr) const {
+            if(t == 0) {
+                l = r = 0;
+                hl = hr = 0;
+                return;
+            }
+            base_ptr tl = t -> left;
+            base_ptr tr = t -> right;
+            size_t htl = child_black_height(tl, ht);
+            size_t htr = child_black_height(tr, ht);
+            if(key_compare(key(t), k)) {
+                split_lower(tr, htr, k, l, hl, r, hr);
+                l = join_nodes(tl, htl, t, l, hl, hl);
+            }else {
+                split_lower(tl, htl, k, l, hl, r, hr);
+                r = join_nodes(r, hr, t, tr, htr, hr);
+            }
+        }
+
+        //集合运算：以a的根的键值切开b，两侧递归求解(可以并行)，再用a的根或join2连起来
+        enum { _set_union, _set_intersection, _set_difference };
+        template <class Fork>
+        struct set_op_task {
+            rb_tree* tree;
+            int op;
+            base_ptr a;
+            size_t ha;
+            base_ptr b;
+            size_t hb;
+            base_ptr* out;
+            size_t* out_height;
+            _rb_tree_garbage* garbage;
+            Fork* fork;
+            int depth;
+            void operator() () { *out = tree -> set_op(op, a, ha, b, hb, *out_height, *garbage, *fork, depth); }
+        };
+        //ha、hb为a、b的黑高度，结果的黑高度由h返回
+        template <class Fork>
+        base_ptr set_op(int op, base_ptr a, size_t ha, base_ptr b, size_t hb, size_t& h,
+                        _rb_tree_garbage& garbage, Fork& fork, int depth) {
+            if(a == 0 || b == 0) {
+                if(op == _set_union) {
+                    h = a ? ha : hb;
+                    return a ? a : b;
+                }
+                garbage.push(b);
+                if(op == _set_intersection) {
+                    garbage.push(a);
+                    h = 0;
+                    return 0;
+                }
+                h = ha;
+                return a;
+            }
+            size_t hal = child_black_height(a -> left, ha);
+            size_t har = child_black_height(a -> right, ha);
+            base_ptr l2, r2;
+            size_t hl2, hr2;
+            base_ptr mid = split_nodes(b, hb, key(a), l2, hl2, r2, hr2);
+            base_ptr l, r;
+            size_t hl, hr;
+            _rb_tree_garbage right_garbage;
+            set_op_task<Fork> left_task = { this, op, a -> left, hal, l2, hl2, &l, &hl, &garbage, &fork, depth + 1 };
+            set_op_task<Fork> right_task = { this, op, a -> right, har, r2, hr2, &r, &hr, &right_garbage, &fork, depth + 1 };
+            fork(left_task, right_task, depth);
+            garbage.splice(right_garbage);
+            //键值相同时保留a中的节点
+            if(mid) garbage.push_node(mid);
+            bool keep = op == _set_union || (op == _set_intersection) == (mid != 0);
+            if(keep)
+                return join_nodes(l, hl, a, r, hr, h);
+            garbage.push_node(a);
+            return join2(l, hl, r, hr, h);
+        }
+        template <class Fork>
+        void set_op_root(int op, rb_tree& x, Fork& fork) {
+            size_type n = node_count + x.node_count;
+            _rb_tree_garbage garbage;
+            size_t h;
+            base_ptr t = set_op(op, root(), black_height(root()), x.root(), black_height(x.root()), h, garbage, fork, 0);
+            x.empty_initialize();
+            for(base_ptr p = garbage.head; p != 0; ) {
+                base_ptr next = p -> parent();
+                n -= erase_subtree(p);
+                p = next;
+            }
+            reset_root(t, n);
+        }
+        template <class ForwardIterator>
+        link_type build_nodes(ForwardIterator& first, size_type n, size_type depth, size_type red_depth) {
+            if(n == 0) return 0;
+            size_type nl = (n - 1) / 2;
+            link_type l = build_nodes(first, nl, depth + 1, red_depth);
+            link_type x;
+            try {
+                x = create_node(*first);
+            }
+            catch(...) {
+                erase_subtree(l);
+                throw;
+            }
+            ++first;
+            link_type r;
+            try {
+                r = build_nodes(first, n - 1 - nl, depth + 1, red_depth);
+            }
+            catch(...) {
+                erase_subtree(l);
+                destroy_node(x);
+                throw;
+            }
+            x -> set_parent_and_color(0, depth >= red_depth ? _rb_tree_red : _rb_tree_black);
+            x -> left = l;
+            x -> right = r;
+            if(l) l -> set_parent(x);
+            if(r) r -> set_parent(x);
+            augment_hook::update(x);
+            return x;
+        }
+    public:
+        rb_tree(const Compare& comp = Compare()) : key_compare(comp) { empty_initialize(); }
+        rb_tree(const rb_tree& x) : key_compare(x.key_compare) {
+            empty_initialize();
+            if(x.root() != 0) {
+                set_root(copy(x.root(), &header));
+                leftmost() = _rb_tree_node_base::minimum(root());
+                rightmost() = _rb_tree_node_base::maximum(root());
+                node_count = x.node_count;
+            }
+        }
+        rb_tree& operator= (const rb_tree& x) {
+            if(this != &x) {
+                rb_tree tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        ~rb_tree() { clear(); }
+
+        Compare key_comp() const { return key_compare; }
+        iterator begin() { return leftmost(); }
+        iterator end() { return &header; }
+        const_iterator begin() const { return leftmost(); }
+        const_iterator end() const { return header_ptr(); }
+        bool empty() const { return node_count == 0; }
+        size_type size() const { return node_count; }
+        size_type max_size() const { return size_type(-1); }
+
+        //header的地址随对象而定，交换后让根重新指回各自的header
+        void swap(rb_tree& x) {
+            _rb_tree_node_base tmp = header;
+            header = x.header;
+            x.header = tmp;
+            size_type n = node_count;
+            node_count = x.node_count;
+            x.node_count = n;
+            Compare c = key_compare;
+            key_compare = x.key_compare;
+            x.key_compare = c;
+            if(root()) root() -> set_parent(&header);
+            else empty_initialize();
+            if(x.root()) x.root() -> set_parent(&x.header);
+            else x.empty_initialize();
+        }
+
+        //键值不允许重复，已存在时返回该节点和false
+        pair<iterator, bool> insert_unique(const value_type& v) {
+            base_ptr y = &header;
+            base_ptr x = root();
+            bool comp = true;
+            while(x != 0) {
+                y = x;
+                comp = key_compare(KeyOfValue()(v), key(x));
+                x = comp ? x -> left : x -> right;
+            }
+            iterator j = iterator(y);
+            if(comp) {
+                if(j == begin())
+                    return pair<iterator, bool>(insert(x, y, v), true);
+                --j;
+            }
+            if(key_compare(key(j.node), KeyOfValue()(v)))
+                return pair<iterator, bool>(insert(x, y, v), true);
+            return pair<iterator, bool>(j, false);
+        }
+        //键值允许重复，相等的键插在已有键之后
+        iterator insert_equal(const value_type& v) {
+            base_ptr y = &header;
+            base_ptr x = root();
+            while(x != 0) {
+                y = x;
+                x = key_compare(KeyOfValue()(v), key(x)) ? x -> left : x -> right;
+            }
+            return insert(x, y, v);
+        }
+        //带提示的插入：v恰好应在position之前时O(1)(不计平衡)，否则退回普通插入
+        iterator insert_unique(iterator position, const value_type& v) {
+            if(position.node == leftmost()) {
+                if(size() > 0 && key_compare(KeyOfValue()(v), key(position.node)))
+                    return insert(position.node, position.node, v);
+                return insert_unique(v).first;
+            }
+            if(position.node == &header) {
+                if(key_compare(key(rightmost()), KeyOfValue()(v)))
+                    return insert(0, rightmost(), v);
+                return insert_unique(v).first;
+            }
+            iterator before = position;
+            --before;
+            if(key_compare(key(before.node), KeyOfValue()(v)) && key_compare(KeyOfValue()(v), key(position.node))) {
+                //before没有右子节点就挂在before右边，否则position必然没有左子节点
+                if(before.node -> right == 0)
+                    return insert(0, before.node, v);
+                return insert(position.node, position.node, v);
+            }
+            return insert_unique(v).first;
+        }
+        iterator insert_equal(iterator position, const value_type& v) {
+            if(position.node == leftmost()) {
+                if(size() > 0 && !key_compare(key(position.node), KeyOfValue()(v)))
+                    return insert(position.node, position.node, v);
+                return insert_equal(v);
+            }
+            if(position.node == &header) {
+                if(!key_compare(KeyOfValue()(v), key(rightmost())))
+                    return insert(0, rightmost(), v);
+                return insert_equal(v);
+            }
+            iterator before = position;
+            --before;
+            if(!key_compare(KeyOfValue()(v), key(before.node)) && !key_compare(key(position.node), KeyOfValue()(v))) {
+                if(before.node -> right == 0)
+                    return insert(0, before.node, v);
+                return insert(position.node, position.node, v);
+            }
+            return insert_equal(v);
+        }
+        //有序输入时每次都以end()为提示，整体为O(n)次比较
+        template <class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            for(; first != last; ++first)
+                insert_unique(end(), *first);
+        }
+        template <class InputIterator>
+        void insert_equal(InputIterator first, InputIterator last) {
+            for(; first != last; ++first)
+                insert_equal(end(), *first);
+        }
+
+        void erase(iterator position) {
+            base_ptr r = root();
+            base_ptr y = _rb_tree_rebalance_for_erase<augment_hook>(position.node, r, header.left, header.right);
+            set_root(r);
+            destroy_node((link_type) y);
+            --node_count;
+        }
+        //删除键值为k的所有节点，返回删除的个数
+        size_type erase(const key_type& k) {
+            pair<iterator, iterator> p = equal_range(k);
+            size_type n = size_type(distance(p.first, p.second));
+            erase(p.first, p.second);
+            return n;
+        }
+        void erase(iterator first, iterator last) {
+            if(first == begin() && last == end()) {
+                clear();
+            }else {
+                while(first != last)
+                    erase(first++);
+            }
+        }
+        void clear() {
+            if(node_count != 0) {
+                erase_subtree(root());
+                empty_initialize();
+            }
+        }
+
+        //由已排序的区间以O(n)建树，原有元素被清除；区间须按key_comp()单调不减，insert_unique的树须严格递增
+        //按中点递归，前floor(log2(n+1))层是满的，全部染黑；最深一层不满时染红
+        template <class ForwardIterator>
+        void build_from_sorted(ForwardIterator first, ForwardIterator last) {
+            clear();
+            size_type n = 0; //不用distance：区间可能来自std的容器，会与std::distance发生歧义
+            for(ForwardIterator i = first; i != last; ++i)
+                ++n;
+            size_type full_levels = 0;
+            while((size_type(1) << (full_levels + 1)) - 1 <= n)
+                ++full_levels;
+            base_ptr t = build_nodes(first, n, 0, full_levels);
+            reset_root(t, n);
+        }
+        //x中的键值都不小于*this中的键值：把x接在*this之后，x被清空。O(log n)
+        void join(rb_tree& x) {
+            if(x.empty()) return;
+            if(empty()) {
+                swap(x);
+                return;
+            }
+            size_type n = node_count + x.node_count;
+            base_ptr l = root();
+            base_ptr k = split_last(l);
+            base_ptr r = x.root();
+            x.empty_initialize();
+            size_t h;
+            reset_root(join_nodes(l, black_height(l), k, r, black_height(r), h), n);
+        }
+        //把键值不小于k的元素移到x中，x必须为空
+        //树的切分为O(log n)，但两边的size()需要重新数：同时从两边数起，代价是较小一边的元素个数
+        //所以总代价为O(log n + min(size(), x.size()))，从中间切开时是线性的
+        void split(const key_type& k, rb_tree& x) {
+            size_type total = node_count;
+            base_ptr l, r;
+            size_t hl, hr;
+            split_lower(root(), black_height(root()), k, l, hl, r, hr);
+            reset_root(l, 0);
+            x.reset_root(r, 0);
+            const_iterator i = begin();
+            const_iterator j = x.begin();
+            size_type n = 0;
+            while(i != end() && j != x.end()) {
+                ++i;
+                ++j;
+                ++n;
+            }
+            if(i == end()) {
+                node_count = n;
+                x.node_count = total - n;
+            }else {
+                x.node_count = n;
+                node_count = total - n;
+            }
+        }
+        //集合运算：要求两棵树的键值都唯一且比较准则相同；结果留在*this中，x被清空，丢弃的元素被销毁
+        //键值相同时保留*this中的元素；O(m log(n/m + 1))，m、n分别为两树中较小、较大的元素个数
+        //fork决定两个子问题是否并行执行，默认serial_fork；并行时节点的释放仍在调用者线程中进行
+        template <class Fork>
+        void set_union(rb_tree& x, Fork fork) { set_op_root(_set_union, x, fork); }
+        template <class Fork>
+        void set_intersection(rb_tree& x, Fork fork) { set_op_root(_set_intersection, x, fork); }
+        template <class Fork>
+        void set_difference(rb_tree& x, Fork fork) { set_op_root(_set_difference, x, fork); }
+        void set_union(rb_tree& x) { set_union(x, serial_fork()); }
+        void set_intersection(rb_tree& x) { set_intersection(x, serial_fork()); }
+        void set_difference(rb_tree& x) { set_difference(x, serial_fork()); }
+
+        //第一个不小于k的节点
+        iterator lower_bound(const key_type& k) {
+            base_ptr y = &header;
+            base_ptr x = root();
+            while(x != 0) {
+                if(!key_compare(key(x), k)) {
+                    y = x;
+                    x = x -> left;
+                }else {
+                    x = x -> right;
+                }
+            }
+            return iterator(y);
+        }
+        const_iterator lower_bound(const key_type& k) const {
+            return const_cast<rb_tree*>(this) -> lower_bound(k);
+        }
+        //第一个大于k的节点
+        iterator upper_bound(const key_type& k) {
+            base_ptr y = &header;
+            base_ptr x = root();
+            while(x != 0) {
+                if(key_compare(k, key(x))) {
+                    y = x;
+                    x = x -> left;
+                }else {
+                    x = x -> right;
+                }
+            }
+            return iterator(y);
+        }
+        const_iterator upper_bound(const key_type& k) const {
+            return const_cast<rb_tree*>(this) -> upper_bound(k);
+        }
+        pair<iterator, iterator> equal_range(const key_type& k) {
+            return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+        }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+        }
+        iterator find(const key_type& k) {
+            iterator j = lower_bound(k);
+            return (j == end() || key_compare(k, key(j.node))) ? end() : j;
+        }
+        const_iterator find(const key_type& k) const {
+            return const_cast<rb_tree*>(this) -> find(k);
+        }
+        size_type count(const key_type& k) const {
+            pair<const_iterator, const_iterator> p = equal_range(k);
+            return size_type(distance(p.first, p.second));
+        }
+
+        friend bool operator== (const rb_tree& x, const rb_tree& y) {
+            if(x.size() != y.size()) return false;
+            const_iterator i = x.begin();
+            const_iterator j = y.begin();
+            for(; i != x.end(); ++i, ++j)
+                if(!(*i == *j)) return false;
+            return true;
+        }
+        //字典序比较
+        friend bool operator< (const rb_tree& x, const rb_tree& y) {
+            const_iterator i = x.begin();
+            const_iterator j = y.begin();
+            for(; i != x.end() && j != y.end(); ++i, ++j) {
+                if(*i < *j) return true;
+                if(*j < *i) return false;
+            }
+            return i == x.end() && j != y.end();
+        }
+    };
 }
 #endif //MY_STL_RB_TREE_H
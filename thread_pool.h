@@ -0,0 +1,229 @@
+#ifndef MY_STL_THREAD_POOL_H
+#define MY_STL_THREAD_POOL_H
+//工作窃取线程池
+//每个工作线程有一个ws_deque：自己产生的任务压在尾端并从尾端取(LIFO，缓存友好)
+//空闲时从其它线程的头端窃取(FIFO，偷到的通常是较大的子任务)
+//外部线程提交的任务先进入共享的mpmc_queue
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include "alloc.h"
+#include "cons.h"
+#include "ws_deque.h"
+#include "mpmc_queue.h"
+#include "wait_strategy.h"
+namespace my_stl{
+    //任务基类，execute执行并释放自身；任务不应抛出异常
+    struct _pool_task {
+        void (*execute)(_pool_task*);
+    };
+    template <class F, class Alloc>
+    struct _pool_task_impl : public _pool_task {
+        typedef my_alloc<_pool_task_impl, Alloc> task_allocator;
+        F f;
+        explicit _pool_task_impl(const F& fn) : f(fn) {
+            execute = &execute_impl;
+        }
+        static _pool_task* create(const F& fn) {
+            _pool_task_impl* p = task_allocator::allocate();
+            construct(p, fn);
+            return p;
+        }
+        static void execute_impl(_pool_task* t) {
+            _pool_task_impl* self = static_cast<_pool_task_impl*>(t);
+            self->f();
+            destroy(self);
+            task_allocator::deallocate(self);
+        }
+    };
+
+    template <class Alloc = malloc_alloc>
+    class work_stealing_pool {
+    public:
+        typedef size_t size_type;
+    protected:
+        typedef _pool_task* task_pointer;
+        struct worker {
+            ws_deque<task_pointer, Alloc> tasks;
+            std::thread thread;
+            uint64_t seed; //选择窃取对象用的xorshift状态
+        };
+        typedef my_alloc<char, Alloc> byte_allocator;
+
+        char* storage;  //worker含alignas(64)的ws_deque，配置器不保证64字节对齐，多配一些再在其中对齐
+        worker* workers;
+        size_type nworkers;
+        mpmc_queue<task_pointer, yield_wait_strategy, Alloc> injection; //外部提交的任务
+        futex_wait_strategy idle;  //没有任务时工作线程在这里睡眠
+        std::atomic<bool> stopping;
+
+        //当前线程所属的线程池及下标，非工作线程为0/-1
+        static work_stealing_pool*& current_pool() {
+            static thread_local work_stealing_pool* p = 0;
+            return p;
+        }
+        static size_type& current_index() {
+            static thread_local size_type i = size_type(-1);
+            return i;
+        }
+        bool on_worker() const { return current_pool() == this; }
+        static size_t storage_bytes(size_type n) { return n * sizeof(worker) + alignof(worker) - 1; }
+
+        static uint64_t next_random(uint64_t& s) {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            return s;
+        }
+        //依次尝试：自己的队列 -> 外部队列 -> 随机窃取
+        bool find_task(size_type self, uint64_t& seed, task_pointer& t) {
+            if(self != size_type(-1) && workers[self].tasks.pop_back(t))
+                return true;
+            if(injection.try_pop(t))
+                return true;
+            size_type start = size_type(next_random(seed) % nworkers);
+            for(size_type i = 0; i != nworkers; ++i) {
+                size_type victim = (start + i) % nworkers;
+                if(victim != self && workers[victim].tasks.pop_front(t))
+                    return true;
+            }
+            return false;
+        }
+        void worker_loop(size_type self) {
+            current_pool() = this;
+            current_index() = self;
+            uint64_t& seed = workers[self].seed;
+            task_pointer t;
+            for(;;) {
+                if(find_task(self, seed, t)) {
+                    t->execute(t);
+                    continue;
+                }
+                uint32_t e = idle.prepare_wait();
+                if(find_task(self, seed, t)) {
+                    idle.cancel_wait();
+                    t->execute(t);
+                    continue;
+                }
+                if(stopping.load(std::memory_order_acquire)) {
+                    idle.cancel_wait();
+                    break;
+                }
+                idle.wait(e);
+            }
+            current_pool() = 0;
+            current_index() = size_type(-1);
+        }
+        void submit_task(task_pointer t) {
+            if(on_worker())
+                workers[current_index()].tasks.push_back(t);
+            else
+                injection.push(t);
+            idle.notify();
+        }
+    private:
+        work_stealing_pool(const work_stealing_pool&);
+        work_stealing_pool& operator= (const work_stealing_pool&);
+    public:
+        explicit work_stealing_pool(size_type n = 0) : injection(4096), stopping(false) {
+            if(n == 0) n = std::thread::hardware_concurrency();
+            if(n == 0) n = 1;
+            nworkers = n;
+            storage = byte_allocator::allocate(storage_bytes(n));
+            workers = reinterpret_cast<worker*>((reinterpret_cast<uintptr_t>(storage) + alignof(worker) - 1)
+                                                & ~uintptr_t(alignof(worker) - 1));
+            for(size_type i = 0; i != n; ++i) {
+                new(&workers[i].tasks) ws_deque<task_pointer, Alloc>();
+                workers[i].seed = 0x9E3779B97F4A7C15ull * (i + 1);
+            }
+            for(size_type i = 0; i != n; ++i)
+                new(&workers[i].thread) std::thread(&work_stealing_pool::worker_loop, this, i);
+        }
+        //等已提交的任务执行完再退出
+        ~work_stealing_pool() {
+            stopping.store(true, std::memory_order_release);
+            idle.notify_all();
+            for(size_type i = 0; i != nworkers; ++i) {
+                workers[i].thread.join();
+                workers[i].thread.~thread();
+                workers[i].tasks.~ws_deque();
+            }
+            byte_allocator::deallocate(storage, storage_bytes(nworkers));
+        }
+        size_type size() const { return nworkers; }
+
+        template <class F>
+        void submit(const F& f) {
+            submit_task(_pool_task_impl<F, Alloc>::create(f));
+        }
+        //在当前线程上执行一个待处理任务，没有任务时返回false；用于等待时帮忙干活
+        bool run_one() {
+            size_type self = on_worker() ? current_index() : size_type(-1);
+            uint64_t seed = reinterpret_cast<uintptr_t>(&self) | 1;
+            task_pointer t;
+            if(!find_task(self, seed, t))
+                return false;
+            t->execute(t);
+            return true;
+        }
+    };
+
+    //fork-join辅助：run()派生子任务，wait()在子任务完成前帮助执行其它任务而不是阻塞
+    template <class Alloc = malloc_alloc>
+    class task_group {
+    protected:
+        typedef work_stealing_pool<Alloc> pool_type;
+        pool_type& pool;
+        std::atomic<size_t> pending;
+
+        template <class F>
+        struct counted {
+            F f;
+            std::atomic<size_t>* pending;
+            void operator() () {
+                f();
+                pending->fetch_sub(1, std::memory_order_release);
+            }
+        };
+    private:
+        task_group(const task_group&);
+        task_group& operator= (const task_group&);
+    public:
+        explicit task_group(pool_type& p) : pool(p), pending(0) {}
+        ~task_group() { wait(); }
+        template <class F>
+        void run(const F& f) {
+            pending.fetch_add(1, std::memory_order_relaxed);
+            counted<F> c = { f, &pending };
+            pool.submit(c);
+        }
+        void wait() {
+            while(pending.load(std::memory_order_acquire) != 0) {
+                if(!pool.run_one())
+                    std::this_thread::yield();
+            }
+        }
+    };
+
+    //分治算法的并行分叉策略(如rb_tree的集合运算)：递归深度小于depth_limit时
+    //把第一个子问题交给线程池，第二个在当前线程执行，然后等待(等待期间帮忙执行任务)
+    template <class Alloc = malloc_alloc>
+    struct pool_fork {
+        work_stealing_pool<Alloc>* pool;
+        int depth_limit;
+        template <class F1, class F2>
+        void operator() (F1& f1, F2& f2, int depth) const {
+            if(depth >= depth_limit) {
+                f1();
+                f2();
+                return;
+            }
+            task_group<Alloc> g(*pool);
+            g.run(f1);
+            f2();
+            g.wait();
+        }
+    };
+}
+#endif //MY_STL_THREAD_POOL_H
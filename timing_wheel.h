@@ -0,0 +1,151 @@
+#ifndef MY_STL_TIMING_WHEEL_H
+#define MY_STL_TIMING_WHEEL_H
+//分层时间轮：管理大量定时器(例如连接超时)，schedule/cancel为O(1)，advance每个tick均摊O(1)
+//共Levels层，每层64个槽；第L层的一个槽覆盖64^L个tick，到期时间离当前越远放得越高
+//时间走到上一层某个槽的起点时，把槽里的定时器按剩余时间重新放到低层(cascade)，每个定时器至多下移Levels-1次
+//槽是intrusive_list，定时器自带钩子，挂上摘下都不配置内存；定时器由使用者管理，须在销毁前cancel
+//时间轮不读取任何时钟，时间只随advance前进，所以同样的调用序列总是得到同样的结果，测试中可直接模拟时间
+//超出64^Levels - 1个tick的定时器先放在最高层最远的槽，轮到时再按真实的到期时间重新放置
+#include <cstddef>
+#include <cstdint>
+#include "intrusive_list.h"
+namespace my_stl{
+    //定时器继承此钩子
+    struct timing_wheel_hook : public intrusive_list_hook {
+        uint64_t expires;  //到期的tick
+        unsigned slot;     //所在的槽：层 * 64 + 槽号
+        timing_wheel_hook() : expires(0), slot(0) {}
+        bool is_scheduled() const { return is_linked(); }
+    };
+
+    template <class T, size_t Levels = 4>
+    class timing_wheel {
+    public:
+        typedef T value_type;
+        typedef uint64_t tick_type;
+        typedef size_t size_type;
+    protected:
+        typedef intrusive_list<T> slot_list;
+        enum { slot_bits = 6, slots = 1 << slot_bits, slot_mask = slots - 1 };
+
+        slot_list wheel[Levels][slots];
+        uint64_t occupied[Levels];  //每层哪些槽非空
+        tick_type current;
+        size_type count;
+
+        static tick_type max_delay() { return (tick_type(1) << (slot_bits * Levels)) - 1; }
+        //按到期时间与当前时间之差选层，同一层内按到期时间的相应位选槽
+        void place(T& t) {
+            tick_type e = t.expires;
+            tick_type d = e - current;
+            if(d > max_delay()) {
+                d = max_delay();
+                e = current + d;
+            }
+            size_t level = 0;
+            while(level + 1 < Levels && d >= (tick_type(1) << (slot_bits * (level + 1))))
+                ++level;
+            size_t idx = size_t(e >> (slot_bits * level)) & slot_mask;
+            t.slot = unsigned(level * slots + idx);
+            wheel[level][idx].push_back(t);
+            occupied[level] |= uint64_t(1) << idx;
+        }
+        //把槽整个摘到tmp中；回调或重新放置时可以放心地修改时间轮
+        void take(size_t level, size_t idx, slot_list& tmp) {
+            tmp.splice(tmp.end(), wheel[level][idx]);
+            occupied[level] &= ~(uint64_t(1) << idx);
+        }
+        void cascade(size_t level) {
+            slot_list tmp;
+            take(level, size_t(current >> (slot_bits * level)) & slot_mask, tmp);
+            while(!tmp.empty()) {
+                T& t = tmp.front();
+                tmp.pop_front();
+                place(t);
+            }
+        }
+        //前进一个tick：先逐层cascade，再触发第0层当前槽中的定时器
+        template <class F>
+        size_type tick(F& f) {
+            ++current;
+            for(size_t level = 1; level < Levels; ++level) {
+                if(current & ((tick_type(1) << (slot_bits * level)) - 1)) break;
+                cascade(level);
+            }
+            slot_list tmp;
+            take(0, size_t(current) & slot_mask, tmp);
+            size_type fired = 0;
+            while(!tmp.empty()) {
+                T& t = tmp.front();
+                tmp.pop_front();
+                //只有一层时超出范围的定时器会落到这里，还没到期
+                if(t.expires != current) {
+                    place(t);
+                    continue;
+                }
+                --count;
+                ++fired;
+                f(t);
+            }
+            return fired;
+        }
+    private:
+        timing_wheel(const timing_wheel&);
+        timing_wheel& operator= (const timing_wheel&);
+    public:
+        explicit timing_wheel(tick_type start = 0) : current(start), count(0) {
+            for(size_t level = 0; level != Levels; ++level)
+                occupied[level] = 0;
+        }
+
+        tick_type now() const { return current; }
+        size_type size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        //在expires时刻触发t；不晚于now()的视为下一个tick到期；t已在轮中时改为新的到期时间
+        void schedule(T& t, tick_type expires) {
+            if(t.is_linked()) cancel(t);
+            t.expires = expires > current ? expires : current + 1;
+            place(t);
+            ++count;
+        }
+        void schedule_after(T& t, tick_type delay) { schedule(t, current + delay); }
+        //t不在轮中时返回false
+        bool cancel(T& t) {
+            if(!t.is_linked()) return false;
+            t.unlink();
+            size_t level = t.slot / slots, idx = t.slot % slots;
+            if(wheel[level][idx].empty())
+                occupied[level] &= ~(uint64_t(1) << idx);
+            --count;
+            return true;
+        }
+        //把时间推进到to，依到期顺序对每个到期的定时器调用f(T&)，返回触发的个数
+        //f中可以schedule或cancel任何定时器，包括刚触发的这一个
+        template <class F>
+        size_type advance(tick_type to, F f) {
+            size_type fired = 0;
+            while(current < to) {
+                if(count == 0) {
+                    current = to;
+                    break;
+                }
+                //到下一个cascade点之前只需看第0层：用occupied跳过空槽
+                tick_type next = current + 1;
+                size_t low = size_t(next) & slot_mask;
+                if(low != 0) {
+                    uint64_t bits = occupied[0] >> low;
+                    tick_type target = bits ? next + tick_type(__builtin_ctzll(bits)) : (next | slot_mask) + 1;
+                    if(target - 1 >= to) {
+                        current = to;
+                        break;
+                    }
+                    current = target - 1;
+                }
+                fired += tick(f);
+            }
+            return fired;
+        }
+    };
+}
+#endif //MY_STL_TIMING_WHEEL_H
@@ -0,0 +1,57 @@
+#ifndef MY_STL_TOP_K_H
+#define MY_STL_TOP_K_H
+//流式top-k：元素逐个喂入，始终保留comp意义下最大的k个；每个元素O(log k)，内存O(k)，适合一遍扫过海量数据
+//内部是一个以第k大元素为堆顶的小顶堆；新元素胜过堆顶时直接顶替堆顶再下沉(一次_adjust_heap)，不必先pop再push
+#include <cstddef>
+#include "alloc.h"
+#include "vector.h"
+#include "heap.h"
+#include "functional.h"
+namespace my_stl{
+    template <class T, class Compare = less<T>, size_t Arity = 2, class Alloc = alloc>
+    class top_k {
+    public:
+        typedef T value_type;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef typename vector<T, Alloc>::const_iterator const_iterator;
+    protected:
+        vector<T, Alloc> c;
+        size_type k;
+        _heap_reverse_compare<Compare> comp;
+    public:
+        explicit top_k(size_type n, const Compare& x = Compare()) : c(), k(n), comp(x) { c.reserve(n); }
+
+        size_type size() const { return c.size(); }
+        bool empty() const { return c.empty(); }
+        size_type capacity() const { return k; }
+        //已保留的元素中最差的一个；满了以后不胜过它的元素会被丢弃
+        const_reference threshold() const { return c[0]; }
+        //保留的元素，无序
+        const_iterator begin() const { return c.begin(); }
+        const_iterator end() const { return c.end(); }
+
+        void push(const value_type& x) {
+            if(c.size() < k) {
+                c.push_back(x);
+                push_heap<Arity>(c.begin(), c.end(), comp);
+            }else if(k != 0 && comp.comp(c[0], x)) {
+                _adjust_heap<Arity>(c.begin(), difference_type(0), difference_type(k), x, comp);
+            }
+        }
+        template <class InputIterator>
+        void push(InputIterator first, InputIterator last) {
+            for(; first != last; ++first)
+                push(*first);
+        }
+        //按从优到劣的顺序返回保留的元素，不改变*this
+        vector<T, Alloc> sorted() const {
+            vector<T, Alloc> r(c);
+            sort_heap<Arity>(r.begin(), r.end(), comp);
+            return r;
+        }
+        void clear() { c.clear(); }
+    };
+}
+#endif //MY_STL_TOP_K_H
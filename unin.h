@@ -4,11 +4,12 @@
 //要么产生所有必要的元素，要么不产生任何元素
 //此处省略了异常处理
 #include "cons.h"
+#include "algorithm.h"
 namespace my_stl {
     template<class InputIterator, class ForwardIterator>
     inline ForwardIterator
     _uninitialized_copy_aux(InputIterator first, InputIterator last, ForwardIterator result, _true_type) {
-        return copy(first, last, result); //调用stl的copy();
+        return copy(first, last, result); //原生指针时为memmove
     }
 
     template<class InputIterator, class ForwardIterator>
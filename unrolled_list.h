@@ -0,0 +1,282 @@
+#ifndef MY_STL_UNROLLED_LIST_H
+#define MY_STL_UNROLLED_LIST_H
+//展开链表：每个节点连续存放至多K个元素
+//相比list每个元素省去两个指针，遍历时每K个元素才跳一次指针；中间插入只移动一个节点内的元素
+//节点满时一分为二，删除后节点过空时与相邻节点合并
+#include <cstddef>
+#include "iterator.h"
+#include "alloc.h"
+#include "cons.h"
+namespace my_stl{
+    struct _unrolled_node_base {
+        typedef _unrolled_node_base* base_ptr;
+        base_ptr prev;
+        base_ptr next;
+    };
+    template <class T, size_t Cap>
+    struct _unrolled_node : public _unrolled_node_base {
+        size_t count;
+        alignas(T) unsigned char storage[sizeof(T) * Cap];
+        T* elems() { return reinterpret_cast<T*>(storage); }
+    };
+    //迭代器：节点指针 + 节点内下标，end()为(哨兵, 0)
+    template <class T, class Ref, class Ptr, size_t Cap>
+    struct _unrolled_iterator {
+        typedef _unrolled_iterator<T, T&, T*, Cap> iterator;
+        typedef _unrolled_iterator<T, Ref, Ptr, Cap> self;
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _unrolled_node_base* base_ptr;
+        typedef _unrolled_node<T, Cap>* link_type;
+
+        base_ptr node;
+        size_t index;
+
+        _unrolled_iterator() {}
+        _unrolled_iterator(base_ptr n, size_t i) : node(n), index(i) {}
+        _unrolled_iterator(const iterator& x) : node(x.node), index(x.index) {}
+
+        bool operator== (const self& x) const { return node == x.node && index == x.index; }
+        bool operator!= (const self& x) const { return !(*this == x); }
+        reference operator*() const { return ((link_type) node)->elems()[index]; }
+        pointer operator->() const { return &(operator*()); }
+        self& operator++() {
+            if(++index == ((link_type) node)->count) {
+                node = node->next;
+                index = 0;
+            }
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--() {
+            if(index == 0) {
+                node = node->prev;
+                index = ((link_type) node)->count;
+            }
+            --index;
+            return *this;
+        }
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+    };
+
+    //K为0时使用默认值：让一个节点约占256字节，至少容纳4个元素
+    template <class T, size_t K = 0, class Alloc = alloc>
+    class unrolled_list {
+    public:
+        enum { node_capacity = K != 0 ? K : (sizeof(T) * 4 + 3 * sizeof(void*) <= 256 ? (256 - 3 * sizeof(void*)) / sizeof(T) : 4) };
+        typedef T value_type;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef _unrolled_iterator<T, T&, T*, node_capacity> iterator;
+        typedef _unrolled_iterator<T, const T&, const T*, node_capacity> const_iterator;
+    protected:
+        typedef _unrolled_node<T, node_capacity> unrolled_node;
+        typedef unrolled_node* link_type;
+        typedef _unrolled_node_base* base_ptr;
+        typedef my_alloc<unrolled_node, Alloc> node_allocator;
+
+        _unrolled_node_base node; //哨兵，嵌在对象中
+        size_type length;
+
+        link_type create_node() {
+            link_type p = node_allocator::allocate();
+            p->count = 0;
+            return p;
+        }
+        void destroy_node(link_type p) {
+            T* e = p->elems();
+            for(size_t i = 0; i != p->count; ++i)
+                destroy(&e[i]);
+            node_allocator::deallocate(p);
+        }
+        //在pos之前链入新节点
+        static void link_before(base_ptr pos, base_ptr p) {
+            p->next = pos;
+            p->prev = pos->prev;
+            pos->prev->next = p;
+            pos->prev = p;
+        }
+        static void unlink(base_ptr p) {
+            p->prev->next = p->next;
+            p->next->prev = p->prev;
+        }
+        //把from[first, from->count)移到to的末尾
+        static void move_tail(link_type from, size_t first, link_type to) {
+            T* src = from->elems();
+            T* dst = to->elems();
+            for(size_t i = first; i != from->count; ++i) {
+                construct(&dst[to->count++], src[i]);
+                destroy(&src[i]);
+            }
+            from->count = first;
+        }
+        //在节点p的下标i处插入x，p必须未满
+        static void insert_in_node(link_type p, size_t i, const T& x) {
+            T* e = p->elems();
+            if(i == p->count) {
+                construct(&e[i], x);
+            }else {
+                construct(&e[p->count], e[p->count - 1]);
+                for(size_t j = p->count - 1; j > i; --j)
+                    e[j] = e[j - 1];
+                e[i] = x;
+            }
+            ++p->count;
+        }
+        //节点p与其后的节点合并(两者元素总数不超过容量时)
+        bool try_merge_next(link_type p) {
+            if(p->next == &node) return false;
+            link_type q = (link_type) p->next;
+            if(p->count + q->count > size_type(node_capacity)) return false;
+            move_tail(q, 0, p);
+            unlink(q);
+            node_allocator::deallocate(q);
+            return true;
+        }
+        void empty_initialize() {
+            node.next = &node;
+            node.prev = &node;
+            length = 0;
+        }
+        static void fix_sentinel(_unrolled_node_base& s, base_ptr old_sentinel) {
+            if(s.next == old_sentinel) {
+                s.next = &s;
+                s.prev = &s;
+            }else {
+                s.next->prev = &s;
+                s.prev->next = &s;
+            }
+        }
+    public:
+        unrolled_list() { empty_initialize(); }
+        unrolled_list(const unrolled_list& x) {
+            empty_initialize();
+            for(const_iterator it = x.begin(); it != x.end(); ++it)
+                push_back(*it);
+        }
+        unrolled_list& operator= (const unrolled_list& x) {
+            if(this != &x) {
+                unrolled_list tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        ~unrolled_list() { clear(); }
+
+        iterator begin() { return iterator(node.next, 0); }
+        iterator end() { return iterator(&node, 0); }
+        const_iterator begin() const { return const_iterator(node.next, 0); }
+        const_iterator end() const { return const_iterator(const_cast<base_ptr>(&node), 0); }
+        bool empty() const { return length == 0; }
+        size_type size() const { return length; }
+        reference front() { return *begin(); }
+        reference back() { return *(--end()); }
+
+        //在position之前插入；节点满时对半分裂
+        iterator insert(iterator position, const T& x) {
+            T x_copy = x; //x可能就是本容器中的元素
+            base_ptr n = position.node;
+            size_t i = position.index;
+            if(n == &node) {
+                //插在末尾：追加到最后一个节点，满了就开新节点(不分裂，保持节点满载)
+                if(node.prev != &node && ((link_type) node.prev)->count < size_type(node_capacity)) {
+                    n = node.prev;
+                    i = ((link_type) n)->count;
+                }else {
+                    link_type p = create_node();
+                    link_before(&node, p);
+                    n = p;
+                    i = 0;
+                }
+            }else if(((link_type) n)->count == size_type(node_capacity)) {
+                link_type p = (link_type) n;
+                link_type q = create_node();
+                link_before(p->next, q);
+                size_t half = p->count / 2;
+                move_tail(p, half, q);
+                if(i > half) {
+                    n = q;
+                    i -= half;
+                }
+            }
+            insert_in_node((link_type) n, i, x_copy);
+            ++length;
+            return iterator(n, i);
+        }
+        void push_back(const T& x) { insert(end(), x); }
+        //在头部插入：第一个节点满时在前面开新节点
+        void push_front(const T& x) {
+            if(node.next == &node || ((link_type) node.next)->count == size_type(node_capacity)) {
+                link_type p = create_node();
+                link_before(node.next, p);
+            }
+            insert_in_node((link_type) node.next, 0, x);
+            ++length;
+        }
+        //删除后节点少于半满时尝试与相邻节点合并；返回被删元素之后的位置
+        iterator erase(iterator position) {
+            link_type p = (link_type) position.node;
+            size_t i = position.index;
+            T* e = p->elems();
+            for(size_t j = i; j + 1 < p->count; ++j)
+                e[j] = e[j + 1];
+            destroy(&e[--p->count]);
+            --length;
+            if(p->count == 0) {
+                base_ptr next = p->next;
+                unlink(p);
+                node_allocator::deallocate(p);
+                return iterator(next, 0);
+            }
+            if(p->count < size_type(node_capacity) / 2) {
+                if(!try_merge_next(p) && p->prev != &node) {
+                    link_type q = (link_type) p->prev;
+                    size_t offset = q->count;
+                    if(try_merge_next(q)) {
+                        p = q;
+                        i += offset;
+                    }
+                }
+            }
+            if(i == p->count)
+                return iterator(p->next, 0);
+            return iterator(p, i);
+        }
+        void pop_front() { erase(begin()); }
+        void pop_back() { erase(--end()); }
+        void clear() {
+            base_ptr cur = node.next;
+            while(cur != &node) {
+                base_ptr next = cur->next;
+                destroy_node((link_type) cur);
+                cur = next;
+            }
+            empty_initialize();
+        }
+        void swap(unrolled_list& x) {
+            _unrolled_node_base tmp = node;
+            node = x.node;
+            x.node = tmp;
+            fix_sentinel(node, &x.node);
+            fix_sentinel(x.node, &node);
+            size_type n = length;
+            length = x.length;
+            x.length = n;
+        }
+    };
+}
+#endif //MY_STL_UNROLLED_LIST_H
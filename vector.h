@@ -4,6 +4,7 @@
 #include "iterator.h"
 #include "cons.h"
 #include "unin.h"
+#include "algorithm.h"
 #include <cstddef>
 namespace my_stl{
     template <class T, class Alloc = alloc>
@@ -12,7 +13,9 @@ namespace my_stl{
         typedef T value_type;
         typedef value_type* pointer;
         typedef value_type* iterator;
+        typedef const value_type* const_iterator;
         typedef value_type& reference;
+        typedef const value_type& const_reference;
         typedef size_t size_type;
         typedef ptrdiff_t difference_type;
     protected:
@@ -36,19 +39,51 @@ namespace my_stl{
     public:
         iterator begin() { return start; }
         iterator end() { return finish; }
-        size_type size()  { return size_type (end() - begin()); }
+        const_iterator begin() const { return start; }
+        const_iterator end() const { return finish; }
+        size_type size() const { return size_type (end() - begin()); }
         size_type capacity() const { return size_type (end_of_storage - begin()); }
-        bool empty() { return begin()==end(); }
+        bool empty() const { return begin()==end(); }
         reference operator[] (size_type n) { return *(begin() + n); }
+        const_reference operator[] (size_type n) const { return *(begin() + n); }
         vector() : start(0), finish(0), end_of_storage(0) {}
         vector(size_type n, const T& value) { fill_initialize(n, value); }
         vector(int n, const T& value) { fill_initialize(n, value); }
         vector(long n, const T& value) { fill_initialize(n,value); }
         explicit vector(size_type n) { fill_initialize(n,T()); }
+        vector(const vector& x) {
+            start = allocate_and_copy(x.size(), x.begin(), x.end());
+            finish = start + x.size();
+            end_of_storage = finish;
+        }
+        vector& operator= (const vector& x) {
+            if(this != &x) {
+                vector tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
         ~vector() {
             destroy(start, finish);
             deallocate();
         }
+        //预留至少n个元素的空间，不改变size()
+        void reserve(size_type n) {
+            if(capacity() < n) {
+                const size_type old_size = size();
+                iterator tmp = allocate_and_copy(n, start, finish);
+                destroy(start, finish);
+                deallocate();
+                start = tmp;
+                finish = tmp + old_size;
+                end_of_storage = start + n;
+            }
+        }
+        void swap(vector& x) {
+            iterator tmp = start; start = x.start; x.start = tmp;
+            tmp = finish; finish = x.finish; x.finish = tmp;
+            tmp = end_of_storage; end_of_storage = x.end_of_storage; x.end_of_storage = tmp;
+        }
         reference front() { return *begin(); }  //第一个元素
         reference back() { return *(end() - 1); } //最后一个元素
         void push_back(const T& x) {
@@ -128,6 +163,7 @@ namespace my_stl{
                     }
                     //清除并释放旧的vector
                     destroy(start, finish);
+                    deallocate();
                     start = new_start;
                     finish = new_finish;
                     end_of_storage = new_start + len;
@@ -147,6 +183,18 @@ namespace my_stl{
             uninitialized_fill_n(result, n, x);
             return result;
         }
+        //配置n个元素的空间并复制[first, last)
+        iterator allocate_and_copy(size_type n, const_iterator first, const_iterator last) {
+            iterator result = data_allocator::allocate(n);
+            try {
+                uninitialized_copy(first, last, result);
+            }
+            catch(...) {
+                data_allocator::deallocate(result, n);
+                throw;
+            }
+            return result;
+        }
 
     };
     template <class T, class Alloc>
@@ -0,0 +1,98 @@
+#ifndef MY_STL_WAIT_STRATEGY_H
+#define MY_STL_WAIT_STRATEGY_H
+//并发容器在满/空时的等待策略
+//使用方式：prepare_wait()取得当前事件号 -> 再次尝试 -> 仍失败则wait(事件号)，成功则cancel_wait()
+//另一端每完成一次操作调用notify()
+#include <atomic>
+#include <thread>
+#include <climits>
+#include <cstdint>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+namespace my_stl{
+    //忙等时提示cpu降低功耗、让出流水线给超线程
+    inline void _cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+    //纯自旋，延迟最低，但会占满一个核
+    class spin_wait_strategy {
+    public:
+        uint32_t prepare_wait() { return 0; }
+        void cancel_wait() {}
+        void wait(uint32_t) { _cpu_relax(); }
+        void notify() {}
+        void notify_all() {}
+    };
+    //让出时间片，适合线程数多于核数的情况
+    class yield_wait_strategy {
+    public:
+        uint32_t prepare_wait() { return 0; }
+        void cancel_wait() {}
+        void wait(uint32_t) { std::this_thread::yield(); }
+        void notify() {}
+        void notify_all() {}
+    };
+    //先自旋一小段，再用futex挂起线程；notify只在有等待者时才进入内核
+    class futex_wait_strategy {
+    private:
+        enum { _spin_limit = 64 };
+        std::atomic<uint32_t> epoch;   //事件号，每次notify加1
+        std::atomic<uint32_t> waiters; //正在(或准备)睡眠的线程数
+    public:
+        futex_wait_strategy() : epoch(0), waiters(0) {}
+        uint32_t prepare_wait() {
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+            //与notify()中的fence配对：要么对方看到等待者，要么这边的重试看到对方的数据
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return epoch.load(std::memory_order_acquire);
+        }
+        void cancel_wait() {
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        void wait(uint32_t seen) {
+            //短暂自旋，避免刚好错过一次notify就陷入内核
+            for(int i = 0; i < _spin_limit; ++i) {
+                if(epoch.load(std::memory_order_acquire) != seen) {
+                    waiters.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                }
+                _cpu_relax();
+            }
+#ifdef __linux__
+            //epoch仍等于seen时才睡眠，否则立即返回
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, seen, 0, 0, 0);
+#else
+            std::this_thread::yield();
+#endif
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        //快路径只有一个fence和一次读，没有等待者时不写共享变量
+        void notify() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(waiters.load(std::memory_order_relaxed) != 0) {
+                epoch.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+                syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, 1, 0, 0, 0);
+#endif
+            }
+        }
+        //关闭等场合需要唤醒所有等待者
+        void notify_all() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(waiters.load(std::memory_order_relaxed) != 0) {
+                epoch.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+                syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, INT_MAX, 0, 0, 0);
+#endif
+            }
+        }
+    };
+}
+#endif //MY_STL_WAIT_STRATEGY_H
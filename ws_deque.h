@@ -0,0 +1,126 @@
+#ifndef MY_STL_WS_DEQUE_H
+#define MY_STL_WS_DEQUE_H
+//Chase-Lev工作窃取双端队列
+//所有者线程在尾端push_back/pop_back，其它线程(窃取者)从头端pop_front
+//存储是可增长的环形数组；扩容后旧数组可能仍被窃取者读取，因此留到析构时再释放
+//元素以std::atomic<T>保存，T应是可平凡复制的小对象，通常是任务指针
+#include <atomic>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include "alloc.h"
+namespace my_stl{
+    template <class T, class Alloc = malloc_alloc>
+    class ws_deque {
+    public:
+        typedef T value_type;
+        typedef size_t size_type;
+    protected:
+        typedef int64_t index_type; //top/bottom可以比较大小，用有符号数
+        struct ring {
+            index_type mask;   //容量-1
+            ring* retired;     //扩容前的旧数组，串成链表
+            std::atomic<T> slots[1];
+
+            T get(index_type i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+            void put(index_type i, T x) { slots[i & mask].store(x, std::memory_order_relaxed); }
+        };
+        typedef my_alloc<char, Alloc> byte_allocator;
+
+        alignas(64) std::atomic<index_type> top;    //窃取端
+        alignas(64) std::atomic<index_type> bottom; //所有者端
+        std::atomic<ring*> array;
+
+        static size_t ring_bytes(index_type cap) {
+            return sizeof(ring) + (cap - 1) * sizeof(std::atomic<T>);
+        }
+        static ring* new_ring(index_type cap) {
+            ring* r = (ring*) byte_allocator::allocate(ring_bytes(cap));
+            r->mask = cap - 1;
+            r->retired = 0;
+            for(index_type i = 0; i != cap; ++i)
+                new(&r->slots[i]) std::atomic<T>();
+            return r;
+        }
+        static void free_ring(ring* r) {
+            byte_allocator::deallocate((char*) r, ring_bytes(r->mask + 1));
+        }
+        //容量翻倍并复制[t, b)，只由所有者调用
+        ring* grow(ring* old, index_type b, index_type t) {
+            ring* r = new_ring(2 * (old->mask + 1));
+            for(index_type i = t; i != b; ++i)
+                r->put(i, old->get(i));
+            r->retired = old;
+            array.store(r, std::memory_order_release);
+            return r;
+        }
+    private:
+        ws_deque(const ws_deque&);
+        ws_deque& operator= (const ws_deque&);
+    public:
+        explicit ws_deque(size_type initial_capacity = 256) : top(0), bottom(0) {
+            index_type cap = 2;
+            while(cap < index_type(initial_capacity)) cap <<= 1;
+            array.store(new_ring(cap), std::memory_order_relaxed);
+        }
+        ~ws_deque() {
+            ring* r = array.load(std::memory_order_relaxed);
+            while(r) {
+                ring* next = r->retired;
+                free_ring(r);
+                r = next;
+            }
+        }
+        //并发时只是近似值
+        size_type size() const {
+            index_type b = bottom.load(std::memory_order_relaxed);
+            index_type t = top.load(std::memory_order_relaxed);
+            return b > t ? size_type(b - t) : 0;
+        }
+        bool empty() const { return size() == 0; }
+
+        //所有者：尾端压入
+        void push_back(T x) {
+            index_type b = bottom.load(std::memory_order_relaxed);
+            index_type t = top.load(std::memory_order_acquire);
+            ring* a = array.load(std::memory_order_relaxed);
+            if(b - t > a->mask)
+                a = grow(a, b, t);
+            a->put(b, x);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        //所有者：尾端弹出，队列空时返回false
+        bool pop_back(T& x) {
+            index_type b = bottom.load(std::memory_order_relaxed) - 1;
+            ring* a = array.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            //先公布bottom再读top，与窃取者的先读top再读bottom构成全序
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            index_type t = top.load(std::memory_order_relaxed);
+            if(t > b) {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            x = a->get(b);
+            if(t == b) {
+                //只剩最后一个元素，与窃取者竞争
+                bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+        //窃取者：头端弹出，队列空或竞争失败时返回false
+        bool pop_front(T& x) {
+            index_type t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            index_type b = bottom.load(std::memory_order_acquire);
+            if(t >= b) return false;
+            ring* a = array.load(std::memory_order_acquire);
+            x = a->get(t);
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+    };
+}
+#endif //MY_STL_WS_DEQUE_H